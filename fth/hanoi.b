@@ -0,0 +1,37 @@
+Towers of Hanoi
+
+Solves the puzzle for fourteen discs printing each of the 16383
+moves on its own line as the disc letter followed by the tower it
+is taken from and the tower it is put on
+
+The recursion is done with an explicit stack of frames on the tape
+each frame holding the number of discs and the three towers along
+with the state of the call and the whole stack is moved along the
+tape as calls are made and returned from
+
+Most of the work is copying cells between frames and testing flags
+which makes it a good benchmark of a brain f*ck implementation
+
+>>>>>>>>>>>>>>>>>>>>>>>>+>++++++++++++++>+>+++>++>+<<<<<[>>>>>>>[->+>+<<
+]>>[-<<+>>]<[[-]<<<<<<<<[-]>[-]>[-]>[-]>[-]>>>[-]<<<<<<<<<<<<<<<<<<<<<<<
+]<<[->>+>+<<<]>>>[-<<<+>>>]<[[-]>+++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++<<<<<<<<[->>>>>
+>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<.[-]++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++<<<<<<<[->>>>>>>+>+<<<<<<<<]
+>>>>>>>>[-<<<<<<<<+>>>>>>>>]<.[-]+++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++<<<<<<[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>
+>>]<.[-]++++++++++.[-]<<<->+<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<
+<<<<<+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]>>>>>>>>>>>>>>>>-<<<<<<<<<<<<
+<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<+<<<<<]>>>>>[-<<<<<+>
+>>>>]<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<+<<<<<<]>>>>>>[-
+<<<<<<+>>>>>>]<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<+<<
+<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]>>>>>>>>>>>>>>>+>>>>>+>>>]<<<[->>>+>+<<<<
+]>>>>[-<<<<+>>>>]<[[-]>+<<<<<<<<[->>>>>>>>>+>+<<<<<<<<<<]>>>>>>>>>>[-<<<
+<<<<<<<+>>>>>>>>>>]<[[-]<->]<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>
+>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<[[-]<+>]<<[[-]<<<<->>+>>]>[[-]<<<<<->+<<<<
+<[->>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<
+<<<<+>>>>>>>>>>]>>>>>>>>>>>>>>-<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>
+>>>>>>>>+<<<<<<<<<<<<<<<+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<<<<<
+<[->>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<+<<<<<<<]>>>>>>>[-<<<<<<<+>>>
+>>>>]<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<+<<<<<<<<]>>>>
+>>>>[-<<<<<<<<+>>>>>>>>]>>>>>>>>>>>>>+>>>>>+>>>>>]<<]<<<<<<<<]
@@ -0,0 +1,220 @@
+Mandelbrot set
+
+Draws a 40 by 17 character picture of the Mandelbrot set on the
+standard output stopping after at most 16 iterations for each
+point
+
+Each number is held in two cells as a sign and a magnitude in
+fixed point with four fractional bits and no intermediate value
+needs more than a single eight bit cell so the multiplications are
+done a digit in base four at a time with the partial products
+divided down as they are summed
+
+Almost all of the time is spent in small counted loops that move
+and copy cells which makes it a good benchmark of a brain f*ck
+implementation
+
++++++++++++++++++[-[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>]<[-<++>]<[->>>+<+<<]>>[-<<+>>]++++++++++++++++
+>>+<<[->[->-]>[-<<<+>[-]>>>]<+<<]>[-]>[-]<<+<[->>>>>+>+<<<<<<]>>>>>>[-<<
+<<<<+>>>>>>]<[[-]<<<<->>>>]<<<<<[[-]<<<<<<<<<<<+>++++++++++++++++>>>>>>>
+>>[-<<<<<<<<<->>>>>>>>>]>]>[[-]<<<<<<<<<<<---------------->>>>>>>>>[-<<<
+<<<<<<+>>>>>>>>>]>>]<<<<<<<<<<<<<+++++++++++++++++++++++++++++++++++++++
++[->>>>>>>>>>>+++++++++++++++++++++++++++++++++++++++<<<<<<<<<<<[->>>>>>
+>>>>>>>+<+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>[-<<->>]
+<<[->>>+<<+<]>[-<+>]++++++++++++++++++++++++++++++++>>>+<<<[->>[->-]>[-<
+<+<[-]>>>>]<+<<<]>>[-]>[-]<<<+>[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<
+<<<->>>>>]<<<<[[-]<<<<<<<<<<+>++++++++++++++++++++++++++++++++>>>>>>>[-<
+<<<<<<->>>>>>>]>>]<[[-]<<<<<<<<-------------------------------->>>>>>>[-
+<<<<<<<+>>>>>>>]>]<<+[<+>>>>>++++++++++++++++++++++++++++++++<<<<<<<<[->
+>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]>>+<<<[->>[->-]>[-<<<<+>[-]>>>>
+]<+<<<]>>[-]>[-]<++++++++++++++++++++++++++++++++<<<<<<[->>>>>+>>>>+<<<<
+<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<+<<[->[->-]>[-<<<+>[-]>>>]<+<<]>[
+-]>[-]<<<[-<+>]+<[->>+>>>>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<<<<[[-]<->]<[[-
+]<<<<<<[->>>>>>>>>>>>+>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>
+>>>>>>>>]<[->>+<<]>>>>++++<<[->+>-[>+>>]>[+[-<+>]>+>>]<<<<<<]>>>>[-<<<<<
++>>>>>]<[->>>>+<<<<]<<[-]>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>+
+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<
++>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<<<<<+>>>>>>>>]<<<<<<++++<<[->+>-[>+>>]>[
++[-<+>]>+>>]<<<<<<]>>>>[->>>>>+<<<<<]<[->>>>>>>+<<<<<<<]<<[-]>[-]<<<[->>
+>>>>>>>+<<<<<<<<<<+>]<[->+<]>>>>>>>>>>[->[-<<<<<<<<<<<<<<<<+>>>>>+>>>>>>
+>>>>>]<<<<<<<<<<<[->>>>>>>>>>>+<<<<<<<<<<<]>>>>>>>>>>]<<<<<<<<<[-<+>>>>>
+>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<<<<<<<
+<<<[->>>>>>>>>>>>[-<<+>>>+<]>[-<+>]<<<<<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>
+>>>>>>>>>>>+<<<<]>>>>[-<<<<+>>>>]<<<<<<<<<<<<<[->>>>>>>>>>>[-<+>>>+<<]>>
+[-<<+>>]<<<<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<++++>>>>>>>>>>]<[->+>>>+<<<<
+]>>>>[-<<<<+>>>>]<<<[->>[-<<<<<<<<<<<<+>>>>>>>>>>>>>+<]>[-<+>]<<<]<<<<<<
+<<<[-]>>>>>>>>[-]>>[-]>[-]<<<<<<<<<<<<[->>+<<]>>>>++++++++++++++++<<[->+
+>-[>+>>]>[+[-<+>]>+>>]<<<<<<]>>>>[->>>>>>+<<<<<<]<[->>>>>>+<<<<<<]<<[-]>
+[-]>>>>>>>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>
+>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<<<<<<+>>>>>>>>>]
+<<<<<<<++++<<[->+>-[>+>>]>[+[-<+>]>+>>]<<<<<<]>>>>[->>>>>>+<<<<<<]<[-<<<
+<<+>>>>>]<<[-]>[-]<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>+<<<<<<<<+<<<<<<<<<
+<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]>>>>>>>>[-<<<<<<<+>>>>>>>]<<<<<+
++++<<[->+>-[>+>>]>[+[-<+>]>+>>]<<<<<<]>>>>[-<<<<<+>>>>>]<[->>>>>+<<<<<]<
+<[-]>[-]>>>>>>>>[-<<<+>>+>]<[->+<]<<[-<<<<<<<<[-<<+>>>>>>>>>>>>+<<<<<<<<
+<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<]>>>[-<+>>+<]>[-<+>]<<[-<[-<+>>>>
++<<<]>>>[-<<<+>>>]<<]<<<<<<<<<<<[->>>>>>>>>>>+>>+<<<<<<<<<<<<<]>>>>>>>>>
+>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<[-<<<<<<<<<<[->>>>>>>>+>>>>+<<<<<<<<
+<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<]<<[->>++++<<]<<<<<<<<<[-
+>>>>>>>>>+>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]
+<<<<[->[->+>>+<<<]>>>[-<<<+>>>]<<<<]>>>[-]<<<<<<<<<<<<[-]>[-]>>>>>>>>>[-
+]>[-<<<<<<<<<+>>>>>>>>>]<<<<<<<++++++++++++++++<<[->+>-[>+>>]>[+[-<+>]>+
+>>]<<<<<<]>>>>[->>>>+<<<<]<[-<<<<+>>>>]<<[-]>[-]>>>>>>[-<<<<<<<<<<<+>>>>
+>>>>>>>]<<<<<<<<<[-]<<<<<<[->>>>>>+>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>
+>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<<<<<<<<<<<[->>+>>>>>>>>>+<<<<<<<<
+<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<<<<<<<<<<<<<+++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++>>>>>[->>>>>>>>>>+<<<<<<<
+<<<<+>]<[->+<]<<<+>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<[->-]>[->>>>>>>>>>>>>+>
+[-]<<<<<<<<<<<<<]<+>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<[-]>[-]>>>>[-]>>>>>>>>>
+[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<]<<<[->>>>>+>>>>>>
+>>>>>>>>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>]++++++++++++++++<<<<<<<<<<<<<+>>>>>>>>>>>>>[-<<<<<<<<<
+<<<<<[->-]>[-<<<+>>>>>>>>>>>>>>>>[-]<<<<<<<<<<<<]<+>>>>>>>>>>>>>]<<<<<<<
+<<<<<<<[-]>[-]>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<[->>>>>>>+>>>>>>>>>>+<<<<<<<
+<<<<<<<<<<]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<<<<<<
+<<<<[[-]>>>>>>>>>-<<<<<<<<<]<<<<<<<[-]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<
+<+>>>>>>>>>>>>>>>>>]+<<<<<<<<<<<<<<<<<[->+>>>>>>>+<<<<<<<<]>>>>>>>>[-<<<
+<<<<<+>>>>>>>>]<<<<<<<[[-]>>>>>>>>>>>>>>>>-<<<<<<<<<<<<<<<<]<[[-]<[-]>]>
+>>>>>>>>>>>>>>>>[[-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>>>>>>>>>>+<<<
+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<[->+<]>>>++++<<[->+>-[>+>>]>[+[-<+>]>+>>
+]<<<<<<]>>>>[->>>>>+<<<<<]<[-<<<<<+>>>>>]<<[-]>[-]<<<<<<<<<<<<<<[->>>>>>
+>>>>>>>>>>>>>>>>+<<<+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<
+<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<<<<<++++<<[
+->+>-[>+>>]>[+[-<+>]>+>>]<<<<<<]>>>>[->>>+<<<]<[->>>>>>>>+<<<<<<<<]<<[-]
+>[-]>>>>>>>[->+<<<<<<<<<<<+>>>>>>>>>>]<<<<<<<<<<[->>>>>>>>>>+<<<<<<<<<<]
+>>>>>>>>>>>[-<<<[-<<<<<<<<<<<<<<<+>>>>>>>+>>>>>>>>]<<<<<<<<[->>>>>>>>+<<
+<<<<<<]>>>>>>>>>>>]<[-<<<<<<<<<<+>>>>>>>>>>>>>+<<<]>>>[-<<<+>>>]<<<<<<<<
+<<<<<[->>>>>>>>>>>>[-<+>>+<]>[-<+>]<<<<<<<<<<<<<]<[->+>>>>>>>>>>>>>+<<<<
+<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<<<<<<<<<[-
+>>>>>>>>[->>>+>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<<<<]>>>>>>>>>>>[-<<<
+<<<<<<<<++++>>>>>>>>>>>]<<<<<<<<<<<<[->>>>>>>>>>>>+>>+<<<<<<<<<<<<<<]>>>
+>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<[->[-<<<<<<<<<<<<+>>>>>>>>>
+>>>>+<]>[-<+>]<<]<[-]<<<<<<<<<<<[-]>>>>>>>>>[-]>>>>[-]<<<<<<<<<<<<[->+<]
+>>>++++++++++++++++<<[->+>-[>+>>]>[+[-<+>]>+>>]<<<<<<]>>>>[->>>>>>>+<<<<
+<<<]<[->>>>+<<<<]<<[-]>[-]>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>
+>>>>]<<<<[-]<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>++<<<<<<<<<<<<<<<]<<<<<<<[->
+>>>>>>+>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<
+<<<<<<<<<<<<<<<<[->>>>>+>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<]>>>
+>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>
+]<<<<<<<<<<<<<<<<<+<<[->>>>>>>+<+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<<<+>>>>[-
+<<<<<[->-]>[->>>>>>>>>>>>>>>>+<<<<<<<<<<<<[-]<<<]<+>>>>]<<<<<[-]>[-]>>>>
+>>>>>>>>>>>>[[-]<<<<<<<<<<<<<<<<<<<-->>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<
+<<<<[->>>>>>+>>>>>>>>>>>+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<
+<<<<<<<+>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>
+>+>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<-[
+->>>>>>>>>>>>+>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>
+>>>>>]<<[[-]<+>]<<<<<<<<<<<<[-]+>>>>>>>>>>>[->+>>+<<<]>>>[-<<<+>>>]<<[[-
+]<<<<<<<<<<<<->>>>>>>>>>>>]<[[-]<<[-<<<<<<<<+>>>>>>>>>>>+<<<]>>>[-<<<+>>
+>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>+>>>>>>>>>>>+<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>
+>>+<+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>
+>>>>>>>>>]<]<<<<<<<<<<<[[-]>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>+<
+<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>]<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<[->-]>[->>>>>>
+>>>>>>>>>+>>[-]<<<<<<<<<<<<<<<<]<+>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<[-
+]>[-]>>>>>>>>>>>>>>>>>+<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[[-]<->]<<<[[-]<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>+>>>>>>>>>>>>>>+<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<[->>>>>>+>+<<<<<<<]>
+>>>>>>[-<<<<<<<+>>>>>>>]<[-<<<<<<<<<<<<<<->>>>>>>>>>>>>>]<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<]>>[[-]<<<<<[-<<<<<<<<+>>>>
+>>>>>>>>>>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[
+->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<<<<<<<<<<<->>>>>>>>>>>>>>]<<<<<<<<<<<<<<<
+<<<<<<[->>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>
+>>[-<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<]<<<<<<<<<<<<<<]<<<<<<[
+-]>>>>>>>>>>>>>>>[-]+<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+<<+<<<<<<<<<<
+<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<<<[-
+>>>>>+<<+<<<]>>>[-<<<+>>>]>>-[->+>+<<]>>[-<<+>>]<[[-]<<<+>>>]<[-]+<<[->>
+>+>+<<<<]>>>>[-<<<<+>>>>]<[[-]<->]<<<[[-]<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>
+>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<
+<+>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<
+<<<<<[->>>>>>+>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>
+>[-<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<<<]>>[[-]<<<<<<<<<<<<<<<
+<<<<[->+>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>
+[-<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<[->>>>>>>
+>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>
+>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<
+<<<<<<<<[->-]>[->>>>>>>>>>>>>>>>>>+>[-]<<<<<<<<<<<<<<<<<<]<+>>>>>>>>>>>>
+>>>>>>>]<<<<<<<<<<<<<<<<<<<<[-]>[-]>>>>>>>>>>>>>>>>>>>+<[->>+>+<<<]>>>[-
+<<<+>>>]<[[-]<->]<<[[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>+>>>>>>+<<<<<<<<<<<
+<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<<<<<<
+<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<[-<
+<<<<<->>>>>>]<<<<<<<<[-<<<<<<<<<+>>>>>>>>>>>>>>>>>+<<<<<<<<]>>>>>>>>[-<<
+<<<<<<+>>>>>>>>]<<]>[[-]<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>+>>>>>>+<
+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>
+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<
+<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<[
+-<<<<<<->>>>>>]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>+>>>>>>>>>>>>>>>>>+<<<<<<<
+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>
+>>>>>>>>>>>>>>>>>]<]<<]<<<<<[-]<<<<<<<<<<<<<<<<<<<<<<[-]>[-]>[-]>[-]>>>>
+>>>>>>[-<<<<<<+>>>>>>>>>>>>>>>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]
+<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>+>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<
+<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>
+>>>>>>>>]<<<<<<<<<<<<<<<-[->>>>>>>>>>>>>>>>>>>>+<<+<<<<<<<<<<<<<<<<<<]>>
+>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]>>[[-]<<<<<+>>>>
+>]<<<<<<<<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>>>[->>>>>+<<+<<<]>>>[-<<<+>>>]>>[
+[-]<<<<<<<<<<<<<<<<<<<<->>>>>>>>>>>>>>>>>>>>]<<<<<[[-]>>[-<<<<<<<<<<<<<<
+<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<]>>>[-<<<+>>>]<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<[->>+>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>]<<<<<<<<<<<<<<[-<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>
++<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<]<<<<
+<<<<<<<<<<<[[-]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>+<]>[-
+<+>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<+>>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<<<[->-]>[->>>>>>>>>>>>>>>>>+<<[-]<<<<<<<<<<<<<<]
+<+>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<[-]>[-]>>>>>>>>>>>>>>>+>>[->>+<+<]>[-<
++>]>[[-]<<<<->>>>]<<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>+>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<
+[->>>>>+<+<<<<]>>>>[-<<<<+>>>>]>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<->>>>>>>>>
+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>+>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<
+<]<<[[-]<[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<]>>
+>>>[-<<<<<+>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>+<+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]>[-<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<->>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<[-<<<<<<
+<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<]<<<<<<<<<<<<<<<<<<]>>>>>>[-]>>>>
+>>>>>>>[-]>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<
+<<<<[-<<<<<<<<<<<+>>>>>>>>>>>]>>>>>>>>>]<<<<<<<<<<<<<<<[-]>>>>[-]<<<<<<<
+]>>>>>>>++++++++++++++++++++++++++++++++<<<++<<<<<[->>+>>>>>>>>>>>>>>>>>
++<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>
+>>>>>>>>>]<<<<<<<<<<<<<+<<<<[->>>[->-]>[-<<+<<[-]>>>>>]<+<<<<]>>>[-]>[-]
+<<[[-]>>>>++++++++++++++<<<<]>+++<<<<<[->>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<
+<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<<
+<<<<<<<<<<<+<<<<[->>>[->-]>[-<<+<<[-]>>>>>]<+<<<<]>>>[-]>[-]<<[[-]>>>>++
+++++++++++<<<<]>++++<<<<<[->>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<]>>>>
+>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<+<
+<<<[->>>[->-]>[-<<+<<[-]>>>>>]<+<<<<]>>>[-]>[-]<<[[-]>>>>-------------<<
+<<]>++++++<<<<<[->>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>
+>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<+<<<<[->>>[-
+>-]>[-<<+<<[-]>>>>>]<+<<<<]>>>[-]>[-]<<[[-]>>>>++++++++++++++++<<<<]>+++
+++++++<<<<<[->>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>
+>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<+<<<<[->>>[->-]>
+[-<<+<<[-]>>>>>]<+<<<<]>>>[-]>[-]<<[[-]>>>>------------------<<<<]>+++++
++++++++++<<<<<[->>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>
+>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<+<<<<[->>>[->
+-]>[-<<+<<[-]>>>>>]<+<<<<]>>>[-]>[-]<<[[-]>>>>-<<<<]>+++++++++++++++<<<<
+<[->>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<
+<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<+<<<<[->>>[->-]>[-<<+<<[-]
+>>>>>]<+<<<<]>>>[-]>[-]<<[[-]>>>>-------<<<<]>>>>.[-]<<<<<<<<<<<<<<[-]>[
+-]>[-]>[-]>[-]>[-]>[-]<<<<<<<<<]>>>>>>>>>>>>>>>>>++++++++++.[-]<<<<<<<<<
+<<<<<<<[-]>[-]<<<]
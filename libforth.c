@@ -250,8 +250,13 @@ Glossary of Terms:
 /** 
 This file implements a Forth library, so a Forth interpreter can be embedded
 in another application, as such a subset of the functions in this file are
-exported, and are documented in the *libforth.h* header 
+exported, and are documented in the *libforth.h* header. On Unix systems
+the POSIX **clock_gettime** function is used for timing, which has to be
+asked for before any header is included.
 **/
+#if defined(__unix__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
 #include "libforth.h"
 
 /**
@@ -266,12 +271,20 @@ more memory.
 #include <stdarg.h>
 #include <ctype.h>
 #include <errno.h>
+#include <float.h>
 #include <limits.h>
+#include <locale.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
-#include <setjmp.h>
 #include <time.h>
+#include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
 
 /**
 Traditionally Forth implementations were the only program running on the
@@ -293,7 +306,7 @@ are out of the way visually when reading the code).
 @param C expression to bounds check
 @return check index 
 **/
-#define ck(C) check_bounds(o, &on_error, (C), __LINE__, o->core_size)
+#define ck(C) check_bounds(o, (C), __LINE__, o->core_size)
 /**
 @brief This is a wrapper around **check_bounds**, so we do not have to keep
 typing in the line number, as so the name is shorter (and hence the checks
@@ -302,21 +315,21 @@ character pointers instead of cell pointers, like **ck** does.
 @param C expression to bounds check
 @return checked character index 
 **/
-#define ckchar(C) check_bounds(o, &on_error, (C), __LINE__, \
+#define ckchar(C) check_bounds(o, (C), __LINE__, \
 			o->core_size * sizeof(forth_cell_t))
 /**
 @brief This is a wrapper around **check_depth**, to make checking the depth 
 short and simple.
 @param DEPTH current depth of the stack
 **/
-#define cd(DEPTH) check_depth(o, &on_error, S, (DEPTH), __LINE__)
+#define cd(DEPTH) check_depth(o, S + CACHED, (DEPTH), __LINE__)
 /**
 @brief This macro makes sure any dictionary pointers never cross into 
 the stack area.
 @param DPTR a index into the dictionary
 @return checked index 
 **/
-#define dic(DPTR) check_dictionary(o, &on_error, (DPTR))
+#define dic(DPTR) check_dictionary(o, (DPTR))
 /**
 @brief This macro wraps up the tracing function, which we may want to remove.
 @param ENV forth environment
@@ -335,16 +348,97 @@ the debug code.
 #define ck(C) (C)
 #define ckchar(C) (C)
 #define cd(DEPTH) ((void)DEPTH)
-#define dic(DPTR) check_dictionary(o, &on_error, (DPTR))
+#define dic(DPTR) check_dictionary(o, (DPTR))
 #define TRACE(ENV, INSTRUCTION, STK, TOP)
 #endif
 
+/**
+@brief **ckrange** and **ckcharrange** check that the **N** cells, or
+characters, starting at **A** are all within the core, see **check_range**.
+Unlike **ck** they are not removed from release builds, they are used
+before a block of the core is handed to a C function, which would run off
+the end of it otherwise, and are non zero if the check failed.
+**/
+#define ckrange(A, N) check_range(o, (A), (N), o->core_size)
+#define ckcharrange(A, N) check_range(o, (A), (N), \
+			o->core_size * sizeof(forth_cell_t))
+
+/**
+@brief **USE_STACK_CACHE** selects a variant of the virtual machine that
+can keep the second item on the variable stack in a local variable as
+well as the first, see **forth_run**. **CACHED_STATE** is added to an
+instruction when dispatching on it in that state, and **CACHED** is the
+number of extra items held in locals, which **cd** has to take into
+account.
+**/
+#define CACHED_STATE (INSTRUCTION_MASK + 1)
+#ifdef USE_STACK_CACHE
+#define CACHED (cached != 0)
+#define DISPATCH(W) ((W) | cached)
+#else
+#define CACHED (0)
+#define DISPATCH(W) (W)
+#endif
+
+/**
+@brief The number of entries kept in the trace ring buffer, it must be a
+power of two, or zero to remove the ring buffer. See *forth_trace_dump*.
+**/
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE (64u)
+#endif
+
+/**
+@brief **TRACE_RING** records the instruction pointer, instruction and top
+of stack in the trace ring buffer, overwriting the oldest entry. Unlike
+**TRACE** it is cheap enough to leave on in release builds, as it is only
+used when control is transferred, by calling a word or taking a branch, in
+much the same way as the last branch records kept by some processors. The
+instruction is packed into the same cell as the instruction pointer, 
+**TRACE_SHIFT** bits up. The count of entries is kept in **tn** by the
+virtual machine, storing it on every call costs more than writing the
+entry does, so it is only written back to **trace_next** by **TRACE_SYNC**
+when the virtual machine exits, faults or dumps the ring buffer.
+**/
+#if TRACE_RING_SIZE
+#define TRACE_SHIFT (7u)
+#define TRACE_RING(I, W, TOP) do {\
+	forth_cell_t *t_ = o->trace_ring[tn++ & (TRACE_RING_SIZE - 1)];\
+	t_[0] = ((I) << TRACE_SHIFT) | (W);\
+	t_[1] = (TOP); } while (0)
+#define TRACE_SYNC() (o->trace_next = tn)
+#else
+#define TRACE_RING(I, W, TOP)
+#define TRACE_SYNC()
+#endif
+
+/**
+@brief **POLL** checks for an error raised while the virtual machine was
+busy, such as a signal arriving (see **forth_signal**), it is placed in the
+instructions that any loop or recursion has to execute (**RUN**, **BRANCH**
+and **QBRANCH**) so it is never too long before the error is acted upon.
+The same places use up the budget set with **forth_set_budget**, which is
+counted down in **fuel**, see *poll*, and are recorded in the trace ring
+buffer. It comes before the instruction does anything so the instruction
+can be executed again later.
+**/
+#define POLL() TRACE_RING(I, w, f); if (o->fault || !--fuel) goto poll
+
+/**
+@brief **RCHECK** throws before **N** cells are pushed onto the return stack
+if they would reach the limit of the return stack of the current task, see
+**RSTK_END**. Unlike **ck** it is not removed from release builds.
+**/
+#define RCHECK(N) if (m[RSTK] + (N) >= m[RSTK_END]) {\
+		o->fault = THROW_RSTACK_OVERFLOW;\
+		goto on_fault; }
+
 /**
 @brief When we are reading input to be parsed we need a space to hold that
 input, the offset to this area is into a field called **m** in **struct forth**,
 defined later, the offset is a multiple of cells and not chars.  
 **/
-#define STRING_OFFSET       (32u)
+#define STRING_OFFSET       (64u)
 
 /**
 @brief This defines the maximum length of a Forth words name, that is the
@@ -365,6 +459,38 @@ code in *forth.fth* will not work.
 **/
 #define DICTIONARY_START (STRING_OFFSET+MAXIMUM_WORD_LENGTH)
 
+/**
+@brief Each wordlist is split into this many threads, a word goes into the
+thread selected by a hash of its name so that a search only has to look at
+the words in one thread, it must be a power of two.
+**/
+#define WORDLIST_THREADS (16u)
+
+/**
+@brief The maximum number of wordlists in the search order, the search
+order itself is kept in the registers starting at **CONTEXT**.
+**/
+#define MAXIMUM_ORDER (8u)
+
+/**
+@brief The number of floating point numbers the floating point stack can
+hold, each of which takes up **FLOAT_CELLS** cells in the core.
+**/
+#define FLOAT_STACK_SIZE (32u)
+#define FLOAT_CELLS ((sizeof(double) + sizeof(forth_cell_t) - 1) / sizeof(forth_cell_t))
+
+/**
+@brief The layout of a wordlist, which lives in the dictionary like any
+other data. All wordlists are kept in a list, starting from the register
+**WORDLISTS**, so that they can be trimmed when words are forgotten.
+**/
+enum wordlist {
+	WORDLIST_LINK,    /**< previously created wordlist, or zero */
+	WORDLIST_NAME,    /**< PWD field of the word naming it, or zero */
+	WORDLIST_HEADS,   /**< PWD field of the latest word in each thread */
+	WORDLIST_SIZE = WORDLIST_HEADS + WORDLIST_THREADS
+};
+
 /**
 Later we will encounter a field called **CODE**, a field in every Word
 definition and is always present in the Words header. This field contains
@@ -402,6 +528,24 @@ where it is relative to the **PWD** field of a word.
 **/
 #define WORD_LENGTH(CODE) (((CODE) >> WORD_LENGTH_OFFSET) & WORD_MASK)
 
+/**
+@brief **WORD_KEY** and **WORD_THREAD** find the cells before the name of a
+word holding the key of its name and the link to the previous word in its
+thread, see **compile**.
+@param M   the Forth core
+@param PWD the **PWD** field of a word
+**/
+#define WORD_KEY(M, PWD)    ((PWD) - WORD_LENGTH((M)[(PWD) + 1]) - 1)
+#define WORD_THREAD(M, PWD) ((PWD) - WORD_LENGTH((M)[(PWD) + 1]) - 2)
+
+/**
+@brief The key of a name holds its length in characters in its lowest byte,
+masked off by **KEY_LENGTH_MASK**, and a hash of the name in the rest of
+it, **KEY_THREAD** picks the thread of a wordlist a name goes in from that.
+**/
+#define KEY_LENGTH_MASK (0xffu)
+#define KEY_THREAD(KEY) (((KEY) >> 8) & (WORDLIST_THREADS - 1))
+
 /**
 @brief Offset for the word hidden bit
 **/
@@ -593,17 +737,41 @@ static const char *fams[] = {
 };
 
 /**
-@brief The following are different reactions errors can take when
-using **longjmp** to a previous **setjump**.
+@brief The following are different reactions errors can take, they are
+the values accepted by the **RESTART** instruction.
 **/
 enum errors
 {
-	INITIALIZED, /**< setjmp returns zero if returning directly */
+	INITIALIZED, /**< no error */
 	OK,          /**< no error, do nothing */
 	FATAL,       /**< fatal error, this invalidates the Forth image */
 	RECOVERABLE, /**< recoverable error, this will reset the interpreter */
 };
 
+/**
+@brief When one of the checks made by the virtual machine fails it records
+one of the following codes, taken from the table of exception codes in the
+ANS Forth standard, in the **fault** field of **struct forth**. If a 
+**catch** is active the code is thrown to it, otherwise the register
+**ERROR_HANDLER** decides what happens, see **forth_run**.
+**/
+enum throw_codes
+{
+	THROW_STACK_OVERFLOW      = -3,  /**< variable stack overflow */
+	THROW_STACK_UNDERFLOW     = -4,  /**< variable stack underflow */
+	THROW_RSTACK_OVERFLOW     = -5,  /**< return stack overflow */
+	THROW_DICTIONARY_OVERFLOW = -8,  /**< dictionary ran into the stacks */
+	THROW_INVALID_ADDRESS     = -9,  /**< bounds check failed */
+	THROW_DIVISION_BY_ZERO    = -10, /**< division by zero */
+	THROW_RESULT_OUT_OF_RANGE = -11, /**< quotient does not fit in a cell */
+	THROW_UNDEFINED_WORD      = -13, /**< not a word, nor a number */
+	THROW_INVALID_ARGUMENT    = -24, /**< invalid string or task */
+	THROW_FLOAT_OVERFLOW      = -44, /**< floating point stack overflow */
+	THROW_FLOAT_UNDERFLOW     = -45, /**< floating point stack underflow */
+	THROW_ALLOCATE            = -59, /**< out of memory */
+	THROW_FILE_IO             = -37, /**< invalid file access method */
+};
+
 /**
 We can serialize the Forth virtual machine image, saving it to disk so we
 can load it again later. When saving the image to disk it is important
@@ -627,10 +795,15 @@ the version of the file format.
 
 **ENDIAN** is the endianess of the VM
 
-**MAGIC7** is the last magic number.
+**LOG2_SIZE** is the binary logarithm of the size of the core in cells.
+
+**CHECKSUM0**...**CHECKSUM3** are a CRC32C of the core, least significant
+byte first, it is filled in when the core is saved.
 
 When loading the image the magic numbers are checked as well as
-compatibility between the saved image and the compiled Forth interpreter. 
+compatibility between the saved image and the compiled Forth interpreter,
+everything before **LOG2_SIZE** has to match. The checksum is only checked
+if asked for, see **forth_load_verified_core_file**.
 **/
 enum header { /**< Forth header description enum */
 	MAGIC0,     /**< Magic number used to identify file type */
@@ -641,6 +814,10 @@ enum header { /**< Forth header description enum */
 	VERSION,    /**< Version of the image */
 	ENDIAN,     /**< Endianess of the interpreter */
 	LOG2_SIZE,  /**< Log-2 of the size */
+	CHECKSUM0,  /**< CRC32C of the core, least significant byte */
+	CHECKSUM1,  /**< CRC32C ... */
+	CHECKSUM2,  /**< CRC32C ... */
+	CHECKSUM3,  /**< CRC32C, most significant byte */
 	MAX_HEADER_FIELD
 };
 
@@ -688,7 +865,7 @@ The **m** field is laid out as follows, assuming the size of the virtual
 machine is 32768 cells big:
 
 	.-----------------------------------------------.
-	| 0-3F      | 40-7BFF       |7C00-7DFF|7E00-7FFF|
+	| 0-5F      | 60-7BFF       |7C00-7DFF|7E00-7FFF|
 	.-----------------------------------------------.
 	| Registers | Dictionary... | V stack | R stack |
 	.-----------------------------------------------.
@@ -720,7 +897,23 @@ struct forth { /**< FORTH environment */
 	int unget;           /**< single character of push back */
 	bool unget_set;      /**< character is in the push back buffer? */
 	size_t line;         /**< count of new lines read in */
-	forth_cell_t m[];    /**< ~~ Forth Virtual Machine memory */
+	const struct forth_native *natives; /**< translated words, sorted by pc */
+	size_t native_count; /**< number of entries in **natives** */
+	volatile forth_cell_t fault; /**< pending exception code, or zero */
+	forth_cell_t budget; /**< calls and branches per run, zero for no limit */
+	enum forth_status status; /**< reason forth_run last returned */
+	char *feed;          /**< buffer of input added with forth_feed */
+	size_t feed_size;    /**< allocated size of **feed** */
+	forth_cell_t read_xt;/**< word last executed by READ */
+	forth_cell_t *profile;  /**< ring buffer of samples, see forth_profile */
+	size_t profile_size;    /**< number of samples **profile** holds */
+	size_t profile_next;    /**< next sample to write */
+	size_t profile_count;   /**< number of samples taken, up to the size */
+#if TRACE_RING_SIZE
+	forth_cell_t trace_ring[TRACE_RING_SIZE][2]; /**< I and instruction, TOS */
+	size_t trace_next;      /**< count of entries written to **trace_ring** */
+#endif
+	forth_cell_t *m;     /**< ~~ Forth Virtual Machine memory, usually after this */
 };
 
 /**
@@ -790,7 +983,22 @@ More information about X-Macros can be found here:
  X("`error-handler",  ERROR_HANDLER,  28,  "actions to take on error")\
  X("`handler",        THROW_HANDLER,  29,  "exception handler is stored here")\
  X("`signal",         SIGNAL_HANDLER, 30,  "signal handler")\
- X("`x",              SCRATCH_X,      31,  "scratch variable x")
+ X("`x",              SCRATCH_X,      31,  "scratch variable x")\
+ X("`evaluator",      EVAL_FRAME,     32,  "innermost evaluate frame")\
+ X("`catch-exit",     CATCH_EXIT,     33,  "execution token of (uncatch)")\
+ X("`task",           TASK,           34,  "current task control block")\
+ X("`main-task",      MAIN_TASK,      35,  "task control block of interpreter")\
+ X("`resume",         RESUME,         36,  "code field to resume at, or zero")\
+ X("`profiling",      PROFILING,      37,  "sampling profiler on if non zero")\
+ X("current",         CURRENT,        38,  "wordlist new words are added to")\
+ X("`wordlists",      WORDLISTS,      39,  "latest wordlist created")\
+ X("#order",          ORDER,          40,  "number of wordlists searched")\
+ X("context",         CONTEXT,        41,  "search order, first searched first")\
+ X("`fstack",         FLOAT_STACK,    49,  "start of the floating point stack")\
+ X("`fdepth",         FLOAT_DEPTH,    50,  "floating point stack depth")\
+ X("`fliteral",       FLITERAL,       51,  "execution token of (fliteral)")\
+ X("`precision",      PRECISION,      52,  "significant digits printed by f.")\
+ X("`rend",           RSTK_END,       53,  "limit of the return stack of the task")
 
 /**
 @brief The virtual machine registers used by the Forth virtual machine.
@@ -808,6 +1016,12 @@ static const char *register_names[] = { /**< names of VM registers */
 	NULL
 };
 
+static const forth_cell_t register_values[] = { /**< registers are not contiguous */
+#define X(NAME, ENUM, VALUE, HELP) VALUE,
+	XMACRO_REGISTERS
+#undef X
+};
+
 /** 
 @brief The enum **input_stream** lists values of the **SOURCE_ID** register.
 
@@ -837,9 +1051,61 @@ the reason the interpreter defaults to being as silent as possible.
 **/
 enum input_stream {
 	FILE_IN,       /**< file input; this could be interactive input */
-	STRING_IN = -1 /**< string input */
+	STRING_IN = -1, /**< string input */
+	FEED_IN   = -2  /**< string input that more can be added to */
+};
+
+/**
+@brief Tasks share the dictionary, but each task has its own stacks, a
+small area for user variables and somewhere to save its state when
+another task is running, all of which are kept in a task control block.
+**enum task_fields** lists the offsets of the fields in a task control
+block, the register **TASK** points to the block of the current task,
+and the blocks form a circular list linked by **TASK_LINK**.
+
+The interpreter itself runs as the task **MAIN_TASK**, which uses the
+stacks at the end of the core, so its block stops after the user
+variable area. The blocks for the other tasks, which are made by
+the word **task** in *forth.fth*, are **TASK_SIZE** cells big, the
+variable stack and the return stack follow on from the user area.
+**/
+enum task_fields
+{
+	TASK_LINK,    /**< next task in the list */
+	TASK_STATUS,  /**< non zero if the task is awake */
+	TASK_S,       /**< saved variable stack pointer */
+	TASK_TOP,     /**< saved top of the variable stack */
+	TASK_I,       /**< saved instruction pointer */
+	TASK_RSTK,    /**< saved **RSTK** register */
+	TASK_HANDLER, /**< saved **THROW_HANDLER** register */
+	TASK_EVAL,    /**< saved **EVAL_FRAME** register */
+	TASK_VSTART,  /**< bottom of the variable stack */
+	TASK_VEND,    /**< top of the variable stack */
+	TASK_RSTART,  /**< bottom of the return stack */
+	TASK_REND,    /**< limit of the return stack, see **RSTK_END** */
+	TASK_ENTRY,   /**< execution token passed to **ACTIVATE** */
+	TASK_EXIT,    /**< run when the entry returns, points to **TASK_STOP** */
+	TASK_STOP,    /**< contains the **STOP** instruction */
+	TASK_USER,    /**< start of the user variable area */
 };
 
+#define TASK_USER_SIZE   (16u) /**< cells of user variables for each task */
+#define TASK_STACK_SIZE  (64u) /**< size of the stacks of each task */
+
+/**
+@brief The size in cells of a task control block, including the stacks.
+**/
+#define TASK_SIZE (TASK_USER + TASK_USER_SIZE + 2 * TASK_STACK_SIZE + 1)
+
+/**
+@brief The register **RSTK_END** holds the limit of the return stack of the
+current task, the words that push onto the return stack check it and throw
+if they would reach it, as **ck** only checks addresses are in the core,
+and a task running out of return stack would overwrite the dictionary. A
+few cells are kept spare under the limit, for *suspend* to push onto.
+**/
+#define RSTK_SPARE (2u)
+
 /** 
 @brief **enum instructions** contains each virtual machine instruction, a valid
 instruction is less than LAST. One of the core ideas of Forth is that
@@ -932,6 +1198,51 @@ up for debugging purposes (like **pnum**).
  X(2, RESIZE,    "resize",         " r-addr u -- r-addr ior : resize a block of memory")\
  X(2, GETENV,    "getenv",         " c-addr u -- r-addr u : return an environment variable")\
  X(1, BYE,       "(bye)",          " u -- : bye, bye!")\
+ X(1, CATCH,     "catch",          " xt -- exception# | 0 : execute xt, catching exceptions")\
+ X(1, THROW,     "throw",          " exception# -- : throw an exception if non zero")\
+ X(0, UNCATCH,   "(uncatch)",      " -- 0 : return from catch")\
+ X(0, PAUSE,     "pause",          " -- : run the next task that is awake")\
+ X(0, STOP,      "stop",           " -- : put the current task to sleep")\
+ X(2, ACTIVATE,  "activate",       " xt task -- : make a task execute xt")\
+ X(0, NS,        "ns",             " -- u : nanoseconds from a monotonic clock")\
+ X(0, CYCLES,    "cycles",         " -- u : read the processors cycle counter")\
+ X(0, RECENT,    ".trace",         " -- : print the most recently executed instructions")\
+ X(3, TONUMBER,  ">number",        " n c-addr u -- n c-addr u : convert a string to a number")\
+ X(5, PCELLS,    "parse-cells",    " c-addr u addr n char -- c-addr u n : parse delimited numbers into cells")\
+ X(4, FCELLS,    "read-cells",     " addr n char file-id -- n ior : read delimited numbers into cells")\
+ X(4, MEMMEM,    "memory-search",  " r-addr1 u1 r-addr2 u2 -- r-addr | 0 : find a block of memory in another")\
+ X(3, MEMICMP,   "memory-icompare", " r-addr1 r-addr2 u -- n : compare two blocks of memory ignoring case")\
+ X(3, MEMCOUNT,  "memory-count",   " r-addr char u -- u : count a character in a block of memory")\
+ X(3, MEMSETC,   "memory-set-cells", " r-addr x u -- : set a block of memory to u cells of x")\
+ X(3, MEMCHRC,   "memory-locate-cell", " r-addr x u -- r-addr | 0 : locate a cell in a block of memory")\
+ X(5, VMAP,      "vector-map",     " addr1 addr2 addr3 u op -- : addr1[i] = addr2[i] op addr3[i]")\
+ X(5, VSCALAR,   "vector-scalar",  " addr1 addr2 x u op -- : addr1[i] = addr2[i] op x")\
+ X(3, VREDUCE,   "vector-reduce",  " addr u op -- x : combine u cells with op")\
+ X(4, VSCAN,     "vector-scan",    " addr1 addr2 u op -- : addr1[i] = addr2[0] op ... addr2[i]")\
+ X(3, VDOT,      "vector-dot",     " addr1 addr2 u -- x : dot product of two arrays")\
+ X(3, SORT,      "sort-cells",     " addr u signed? -- : sort an array of cells")\
+ X(3, SORTKV,    "sort-pairs",     " addr u signed? -- : stable sort of u key value pairs by key")\
+ X(4, BSEARCH,   "search-cells",   " addr u x signed? -- u bool : binary search of a sorted array")\
+ X(7, SORTSTEP,  "(sort-by)",      " addr state*5 bool -- addr state*5 x1 x2 1 | 0 : step a sort")\
+ X(3, CRC32C,    "crc32c",         " u c-addr u -- u : continue a CRC32C over a block of memory")\
+ X(3, CRC16,     "crc16",          " u c-addr u -- u : continue a CRC-16-CCITT over a block of memory")\
+ X(3, MAPFIND,   "map-find",       " key u map -- x bool : look up a key in a hash map")\
+ X(4, MAPSTORE,  "map-store",      " x key u map -- bool : add or replace a key in a hash map")\
+ X(3, MAPDELETE, "map-delete",     " key u map -- bool : remove a key from a hash map")\
+ X(2, MAPNEXT,   "map-next",       " u map -- u : find the next key in a hash map")\
+ X(3, SEARCHWORDLIST, "search-wordlist", " c-addr u wid -- 0 | xt 1 | xt -1 : find a word in a wordlist")\
+ X(2, UMSTAR,    "um*",            " u u -- ud : multiply two unsigned cells giving a double cell")\
+ X(2, MSTAR,     "m*",             " n n -- d : multiply two signed cells giving a double cell")\
+ X(3, UMSLMOD,   "um/mod",         " ud u -- u u : unsigned double cell division, remainder and quotient")\
+ X(3, SMSLREM,   "sm/rem",         " d n -- n n : signed division rounding towards zero")\
+ X(3, FMSLMOD,   "fm/mod",         " d n -- n n : signed division rounding towards negative infinity")\
+ X(4, DPLUS,     "d+",             " d d -- d : add two double cell numbers")\
+ X(4, DMINUS,    "d-",             " d d -- d : subtract two double cell numbers")\
+ X(2, DNEGATE,   "dnegate",        " d -- d : negate a double cell number")\
+ X(4, DLESS,     "d<",             " d d -- bool : signed comparison of two double cell numbers")\
+ X(0, FLOAT,     "(float)",        " -- : perform the floating point operation in the words body")\
+ X(0, BIGNUM,    "(bignum)",       " -- : perform the bignum operation in the words body")\
+ X(0, REGEX,     "(regex)",        " -- : perform the regular expression operation in the words body")\
  X(0, LAST_INSTRUCTION, NULL, "")
 
 /**
@@ -967,6 +1278,178 @@ static const int stack_bounds[] = { /**< number stack variables needed*/
 #undef X
 };
 
+/**
+The vector instructions take one of these operations as an argument,
+they are made available to the Forth interpreter as constants.
+**/
+#define XMACRO_VECTOR_OPERATIONS\
+ X("vector-add", VECTOR_ADD, "vector operation: addition")\
+ X("vector-sub", VECTOR_SUB, "vector operation: subtraction")\
+ X("vector-mul", VECTOR_MUL, "vector operation: multiplication")\
+ X("vector-and", VECTOR_AND, "vector operation: bitwise and")\
+ X("vector-or",  VECTOR_OR,  "vector operation: bitwise or")\
+ X("vector-xor", VECTOR_XOR, "vector operation: bitwise exclusive or")\
+ X("vector-min", VECTOR_MIN, "vector operation: signed minimum")\
+ X("vector-max", VECTOR_MAX, "vector operation: signed maximum")
+
+enum vector_operations {
+#define X(NAME, ENUM, DESCRIPTION) ENUM,
+	XMACRO_VECTOR_OPERATIONS
+#undef X
+	LAST_VECTOR_OPERATION
+};
+
+/**
+The floating point words all share the one instruction, **FLOAT**, which
+finds the operation to perform in the body of the word, so the word set
+does not use up the few instructions that are left. Along with the name
+of each word is the number of cells it needs on the variable stack, and
+how many floating point numbers it takes from and gives back to the 
+floating point stack, which **FLOAT** checks before any operation.
+**/
+#define XMACRO_FLOAT_OPERATIONS\
+ X(0, 0, 1, FLIT,       "(fliteral)", " -- F: -- r : push the literal in the next cells")\
+ X(1, 1, 0, FSTORE,     "f!",         " addr -- F: r -- : store a floating point number")\
+ X(1, 0, 1, FFETCH,     "f@",         " addr -- F: -- r : load a floating point number")\
+ X(0, 0, 0, FDEPTH,     "fdepth",     " -- u : depth of the floating point stack")\
+ X(0, 1, 0, FDROP,      "fdrop",      " F: r -- ")\
+ X(0, 1, 2, FDUP,       "fdup",       " F: r -- r r")\
+ X(0, 2, 2, FSWAP,      "fswap",      " F: r1 r2 -- r2 r1")\
+ X(0, 2, 3, FOVER,      "fover",      " F: r1 r2 -- r1 r2 r1")\
+ X(0, 3, 3, FROT,       "frot",       " F: r1 r2 r3 -- r2 r3 r1")\
+ X(0, 2, 1, FPLUS,      "f+",         " F: r1 r2 -- r3 : addition")\
+ X(0, 2, 1, FMINUS,     "f-",         " F: r1 r2 -- r3 : subtraction")\
+ X(0, 2, 1, FSTAR,      "f*",         " F: r1 r2 -- r3 : multiplication")\
+ X(0, 2, 1, FSLASH,     "f/",         " F: r1 r2 -- r3 : division")\
+ X(0, 2, 1, FPOWER,     "f**",        " F: r1 r2 -- r3 : raise r1 to the power r2")\
+ X(0, 2, 1, FMAX,       "fmax",       " F: r1 r2 -- r3 : maximum")\
+ X(0, 2, 1, FMIN,       "fmin",       " F: r1 r2 -- r3 : minimum")\
+ X(0, 2, 1, FATAN2,     "fatan2",     " F: r1 r2 -- r3 : arc tangent of r1/r2")\
+ X(0, 1, 1, FNEGATE,    "fnegate",    " F: r1 -- r2 : negate")\
+ X(0, 1, 1, FABS,       "fabs",       " F: r1 -- r2 : absolute value")\
+ X(0, 1, 1, FSQRT,      "fsqrt",      " F: r1 -- r2 : square root")\
+ X(0, 1, 1, FSIN,       "fsin",       " F: r1 -- r2 : sine")\
+ X(0, 1, 1, FCOS,       "fcos",       " F: r1 -- r2 : cosine")\
+ X(0, 1, 1, FTAN,       "ftan",       " F: r1 -- r2 : tangent")\
+ X(0, 1, 1, FATAN,      "fatan",      " F: r1 -- r2 : arc tangent")\
+ X(0, 1, 1, FEXP,       "fexp",       " F: r1 -- r2 : e raised to the power r1")\
+ X(0, 1, 1, FLN,        "fln",        " F: r1 -- r2 : natural logarithm")\
+ X(0, 1, 1, FLOOR,      "floor",      " F: r1 -- r2 : round towards negative infinity")\
+ X(0, 1, 1, FROUND,     "fround",     " F: r1 -- r2 : round to the nearest integer")\
+ X(0, 1, 1, FTRUNC,     "ftrunc",     " F: r1 -- r2 : round towards zero")\
+ X(0, 1, 0, FZLESS,     "f0<",        " -- bool F: r -- : is r less than zero")\
+ X(0, 1, 0, FZEQUAL,    "f0=",        " -- bool F: r -- : is r equal to zero")\
+ X(0, 2, 0, FLESS,      "f<",         " -- bool F: r1 r2 -- : is r1 less than r2")\
+ X(1, 0, 1, STOF,       "s>f",        " n -- F: -- r : convert a signed cell")\
+ X(0, 1, 0, FTOS,       "f>s",        " -- n F: r -- : convert to a signed cell, rounding towards zero")\
+ X(2, 0, 1, DTOF,       "d>f",        " d -- F: -- r : convert a double cell number")\
+ X(0, 1, 0, FTOD,       "f>d",        " -- d F: r -- : convert to a double cell number, rounding towards zero")\
+ X(2, 0, 1, TOFLOAT,    ">float",     " c-addr u -- bool F: -- r | : convert a string")\
+ X(0, 1, 0, FDOT,       "f.",         " F: r -- : print a floating point number")\
+ X(0, 1, 0, FSDOT,      "fs.",        " F: r -- : print a floating point number in scientific notation")\
+ X(1, 0, 0, FLOATS,     "floats",     " u1 -- u2 : size of u1 floating point numbers in cells")\
+ X(1, 0, 0, FLOATPLUS,  "float+",     " addr1 -- addr2 : move to the next floating point number")
+
+enum float_operations {
+#define X(DEPTH, IN, OUT, ENUM, NAME, HELP) ENUM,
+	XMACRO_FLOAT_OPERATIONS
+#undef X
+	LAST_FLOAT_OPERATION
+};
+
+static const char *float_names[] = {
+#define X(DEPTH, IN, OUT, ENUM, NAME, HELP) NAME,
+	XMACRO_FLOAT_OPERATIONS
+#undef X
+	NULL
+};
+
+/**
+The bignum words share the **BIGNUM** instruction in the same way, each
+one has the number of cells it takes off the variable stack and the 
+number it gives back. The bignums themselves are described in the 
+section on arbitrary precision integers.
+**/
+#define XMACRO_BIGNUM_OPERATIONS\
+ X(2, 0, BIG_STORE,     "big!",        " n big -- : store a signed cell in a bignum")\
+ X(1, 1, BIG_TO_CELL,   "big>s",       " big -- n : least significant cell of a bignum, with its sign")\
+ X(2, 0, BIG_COPY,      "big-copy",    " big1 big2 -- : copy big1 into big2")\
+ X(3, 0, BIG_ADD,       "big+",        " big1 big2 big3 -- : big3 = big1 + big2")\
+ X(3, 0, BIG_SUB,       "big-",        " big1 big2 big3 -- : big3 = big1 - big2")\
+ X(3, 0, BIG_MUL,       "big*",        " big1 big2 big3 -- : big3 = big1 * big2")\
+ X(4, 0, BIG_DIVMOD,    "big/mod",     " big1 big2 big3 big4 -- : big3 = big1 / big2, big4 = remainder")\
+ X(4, 0, BIG_POWMOD,    "big**mod",    " big1 big2 big3 big4 -- : big4 = big1 ** big2 mod big3")\
+ X(2, 1, BIG_COMPARE,   "big-compare", " big1 big2 -- n : -1, 0 or 1 as big1 is less, equal or greater")\
+ X(3, 1, BIG_TO_STRING, "big>string",  " big c-addr u1 -- u2 : write a bignum in the current base")\
+ X(3, 1, STRING_TO_BIG, "string>big",  " c-addr u big -- bool : read a bignum in the current base")\
+ X(1, 0, BIG_PRINT,     "big.",        " big -- : print a bignum in the current base")
+
+enum bignum_operations {
+#define X(DEPTH, OUT, ENUM, NAME, HELP) ENUM,
+	XMACRO_BIGNUM_OPERATIONS
+#undef X
+	LAST_BIGNUM_OPERATION
+};
+
+static const char *bignum_names[] = {
+#define X(DEPTH, OUT, ENUM, NAME, HELP) NAME,
+	XMACRO_BIGNUM_OPERATIONS
+#undef X
+	NULL
+};
+
+static const struct bignum_bounds {
+	uint8_t depth; /**< cells taken off the variable stack */
+	uint8_t out;   /**< cells given back */
+} bignum_bounds[] = {
+#define X(DEPTH, OUT, ENUM, NAME, HELP) { DEPTH, OUT },
+	XMACRO_BIGNUM_OPERATIONS
+#undef X
+};
+
+/**
+The regular expression words are the last to share an instruction,
+**REGEX**, they are described in the section on regular expressions.
+**/
+#define XMACRO_REGEX_OPERATIONS\
+ X(4, 1, REGEX_COMPILE, "regex-compile", " c-addr u addr u1 -- u2 : compile a regular expression into u1 cells at addr")\
+ X(3, 1, REGEX_MATCH,   "regex-match",   " c-addr u regex -- bool : does a regular expression match all of a string")\
+ X(3, 3, REGEX_SEARCH,  "regex-search",  " c-addr1 u1 regex -- c-addr2 u2 bool : find the leftmost match in a string")\
+ X(2, 2, REGEX_GROUP,   "regex-group",   " u1 regex -- c-addr u2 : a group captured by the last match")
+
+enum regex_operations {
+#define X(DEPTH, OUT, ENUM, NAME, HELP) ENUM,
+	XMACRO_REGEX_OPERATIONS
+#undef X
+	LAST_REGEX_OPERATION
+};
+
+static const char *regex_names[] = {
+#define X(DEPTH, OUT, ENUM, NAME, HELP) NAME,
+	XMACRO_REGEX_OPERATIONS
+#undef X
+	NULL
+};
+
+static const struct regex_bounds {
+	uint8_t depth; /**< cells taken off the variable stack */
+	uint8_t out;   /**< cells given back */
+} regex_bounds[] = {
+#define X(DEPTH, OUT, ENUM, NAME, HELP) { DEPTH, OUT },
+	XMACRO_REGEX_OPERATIONS
+#undef X
+};
+
+static const struct float_bounds {
+	uint8_t depth; /**< cells needed on the variable stack */
+	uint8_t in;    /**< numbers taken off the floating point stack */
+	uint8_t out;   /**< numbers put on the floating point stack */
+} float_bounds[] = {
+#define X(DEPTH, IN, OUT, ENUM, NAME, HELP) { DEPTH, IN, OUT },
+	XMACRO_FLOAT_OPERATIONS
+#undef X
+};
+
 /**
 This X-Macro contains a list of constants that will be available to the
 Forth interpreter.
@@ -997,7 +1480,13 @@ Forth interpreter.
  X("doconst",     CONST,        "instruction for pushing a constant")\
  X("bl",          ' ',          "space character")\
  X("')'",         ')',          "')' character")\
- X("cell",        1,            "space a single cell takes up")
+ X("cell",        1,            "space a single cell takes up")\
+ X("task-size",   TASK_SIZE,    "size of a task control block")\
+ X("task-user",   TASK_USER,    "offset of the user area in a task")\
+ X("#user",       TASK_USER_SIZE, "number of user variables")\
+ X("#threads",    WORDLIST_THREADS, "number of threads in a wordlist")\
+ X("#order-max",  MAXIMUM_ORDER, "maximum number of wordlists searched")\
+ X("header-size", MAX_HEADER_FIELD, "size of a core file header in bytes")
 
 /**
 @brief A structure that contains a constant to be added to the
@@ -1010,6 +1499,7 @@ static struct constants {
 } constants[] = {
 #define X(NAME, VALUE, DESCRIPTION) { NAME, (VALUE) },
 	X_MACRO_CONSTANTS
+	XMACRO_VECTOR_OPERATIONS
 #undef X
 	{ NULL, 0 }
 };
@@ -1091,6 +1581,7 @@ static int forth_get_char(forth_t *o)
 		r = fgetc((FILE*)(o->m[FIN])); 
 		break;
 	case STRING_IN: 
+	case FEED_IN:
 		r = o->m[SIDX] >= o->m[SLEN] ? 
 			EOF : 
 			((char*)(o->m[SIN]))[o->m[SIDX]++];
@@ -1118,6 +1609,38 @@ static int forth_unget_char(forth_t *o, int ch)
 	return o->unget;
 }
 
+/**
+@brief  Check whether there is enough fed input to carry on reading
+@param  o    initialized Forth environment
+@param  word true if a whole word is needed, false for a character
+@return bool true if reading can go ahead
+
+When the input comes from **forth_feed** running off the end of it does
+not mean the input has ended, the rest of a word might be in the next
+block fed in. So that nothing is lost nothing is read until a whole word,
+one that is followed by a delimiter or is as long as a word can be, is
+in the buffer. Other sources are always ready, they either have input or
+have come to an end.
+**/
+static bool forth_input_ready(forth_t *o, bool word)
+{
+	const char *s = (const char*)(o->m[SIN]);
+	forth_cell_t i = o->m[SIDX], n = 0;
+	if (o->m[SOURCE_ID] != (forth_cell_t)FEED_IN)
+		return true;
+	if (o->unget_set && (!word || !isspace(o->unget)))
+		return true;
+	if (!word)
+		return i < o->m[SLEN];
+	for (; i < o->m[SLEN] && isspace((unsigned char)s[i]); i++)
+		;
+	for (; i < o->m[SLEN]; i++)
+		if (isspace((unsigned char)s[i]) || !s[i] || 
+				++n >= MAXIMUM_WORD_LENGTH - 1)
+			return true;
+	return false;
+}
+
 /**
 @brief get a word (space delimited, up to 31 chars) from a FILE\* or string-in
 @param  o      initialized Forth environment.
@@ -1136,6 +1659,8 @@ static int forth_get_word(forth_t *o, uint8_t *s, forth_cell_t length)
 {
 	int ch;
 	memset(s, 0, length);
+	if (!forth_input_ready(o, true))
+		return -1;
 	for (;;) {
 		ch = forth_get_char(o);
 		if (ch == EOF || !ch)
@@ -1156,6 +1681,23 @@ unget:
 	return 0;
 }
 
+/**
+@brief **forth_name_key** makes the key stored in the header of a word, 
+which holds the length of its name and a hash of it, as names are case
+insensitive it hashes them as lower case.
+@param s name of a word
+@return key of the name
+**/
+static forth_cell_t forth_name_key(const char *s)
+{
+	uint32_t h = 2166136261u;
+	size_t i;
+	for (i = 0; s[i]; i++)
+		h = (h ^ (unsigned char)tolower(s[i])) * 16777619u;
+	h ^= h >> 16;
+	return ((forth_cell_t)h << 8) | (i & KEY_LENGTH_MASK);
+}
+
 /** 
 @brief Compile a Forth word header into the dictionary
 @param o    Forth environment to do the compilation in
@@ -1188,18 +1730,35 @@ taken when we have found the word we are looking for in our Read-Evaluate-Loop.
 	    |                                                     |
 	    |                                                   PWD Register
 
-The **PWD** registers points to the latest defined word, a search starts from
-here and works it way backwards (allowing us replace old definitions by
-appending new ones with the same name), the terminator 'value' is actually any
-value that points before the beginning of the dictionary.
+The **PWD** registers points to the latest defined word, the list can be
+walked backwards from here to visit every word, the terminator 'value' is
+actually any value that points before the beginning of the dictionary.
+
+Searching the whole of this list for every word would be slow, and would
+mean that every word is visible everywhere, so words also belong to a
+wordlist, the one in the **CURRENT** register when they were defined. Each
+wordlist is split into **WORDLIST_THREADS** threads, and a word is linked to
+the previous word in the same wordlist whose name hashes to the same thread,
+the wordlists in the search order are searched in turn by following only the
+thread the name being looked for hashes to. A search of a thread works its
+way backwards, allowing us replace old definitions by appending new ones
+with the same name.
 
 Our word header looks like this:
 
-	.-----------.-----.------.------------.
-	| Word Name | PWD | CODE | Data Field |
-	.-----------.-----.------.------------.
+	.--------.-----.-----------.-----.------.------------.
+	| THREAD | KEY | Word Name | PWD | CODE | Data Field |
+	.--------.-----.-----------.-----.------.------------.
 
 * The **Data Field** is optional and is of variable length.
+* **THREAD** points to the **PWD** field of the previous word in the thread,
+it comes before the name so that the rest of the header can be found from 
+the **PWD** field as it always has been.
+* **KEY** holds the exact length of the name, in characters, in its lowest
+byte, and a hash of the name, folded to lower case, in the rest of it. The
+thread of a word is picked from this hash, and when searching for a word
+comparing keys rejects almost all of the other words in a thread in one go,
+see **forth_name_key** and **match**.
 * **Word Name** is a variable length field whose size is recorded in the
 CODE field.
 
@@ -1235,8 +1794,12 @@ static forth_cell_t compile(forth_t *o, forth_cell_t code, const char *str,
 		forth_cell_t compiling, forth_cell_t hide)
 { 
 	assert(o && code < LAST_INSTRUCTION);
-	forth_cell_t *m = o->m, head = m[DIC], l = 0, cf = 0;
+	forth_cell_t *m = o->m, head, l = 0, cf = 0, key = forth_name_key(str);
+	forth_cell_t thread = m[CURRENT] + WORDLIST_HEADS + KEY_THREAD(key);
 	/*FORTH header structure */
+	m[m[DIC]++] = m[thread]; /* Pointer to previous word in the thread */
+	m[m[DIC]++] = key;       /* Hash and length of the name */
+	head = m[DIC];
 	/*Copy the new FORTH word into the new header */
 	strcpy((char *)(o->m + head), str); 
 	/* align up to size of cell */
@@ -1247,6 +1810,7 @@ static forth_cell_t compile(forth_t *o, forth_cell_t code, const char *str,
 
 	m[m[DIC]++] = m[PWD]; /*0 + STRLEN: Pointer to previous words header */
 	m[PWD] = m[DIC] - 1;  /*Update the PWD register to new word */
+	m[thread] = m[PWD];   /*And the thread it is in */
 	/*size of words name and code field*/
 	assert(l < WORD_MASK);
 	cf = m[DIC];
@@ -1259,211 +1823,2907 @@ static forth_cell_t compile(forth_t *o, forth_cell_t code, const char *str,
 }
 
 /**
-@brief This function turns a string into a number using a base and 
-returns an error code to indicate success or failure, the results of 
-the conversion are stored in **n**, even if the conversion failed.
+@brief **forth_digits** accumulates the digits of a number in a base from 2
+to 36 into **n**, stopping at the first character that is not a digit in
+that base, or at the digit that would make **n** overflow, and returns the
+number of characters used. It is used by **READ**, via 
+**forth_string_to_cell**, and by the **>number** instruction, and is a lot
+quicker than **strtol**, which has to handle locales, white space and 
+*errno*.
 **/
-int forth_string_to_cell(int base, forth_cell_t *n, const char *s)
+static size_t forth_digits(unsigned base, forth_cell_t *n, const char *s, size_t length)
 {
-	char *end = NULL;
-	errno = 0;
-	*n = strtol(s, &end, base);
-	return errno || *s == '\0' || *end != '\0';
+	forth_cell_t u = *n;
+	size_t i = 0;
+	unsigned d;
+	if (base < 2 || base > 36)
+		return 0;
+	for (; i < length; i++) {
+		int c = (unsigned char)s[i];
+		if (c >= '0' && c <= '9')
+			d = c - '0';
+		else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+			d = (c | 0x20) - 'a' + 10;
+		else
+			break;
+		if (d >= base || u > (((forth_cell_t)-1) - d) / base)
+			break;
+		u = u * base + d;
+	}
+	*n = u;
+	return i;
 }
 
-/** 
-@brief Forths are usually case insensitive and are required to be (or
-at least accept only uppercase characters only) by the majority of the
-standards for Forth.  As an aside I do not believe case insensitivity is
-a good idea as it complicates interfaces and creates as much confusion
-as it tries to solve (not only that, but different case letters do convey
-information). However, in keeping with other implementations, this Forth
-is also made insensitive to case **DUP** is treated the same as **dup**
-and **Dup**.
-
-This comparison function, **istrcmp**, is only used in one place however,
-in the C function **forth_find**, replacing it with **strcmp** will
-bring back the more logical, case sensitive, behavior.
-
-@param  a   first string to compare
-@param  b   second string
-@return int same as **strcmp**, only case insensitive
-
+/**
+@brief **forth_number** turns a string of a given length into a number,
+see **forth_string_to_cell**, which it does the work for, it returns non
+zero if the string is not a number.
 **/
-static int istrcmp(const char *a, const char *b)
+static int forth_number(int base, forth_cell_t *n, const char *s, size_t length)
 {
-	for (; ((*a == *b) || (tolower(*a) == tolower(*b))) && *a && *b; a++, b++)
-		;
-	return tolower(*a) - tolower(*b);
+	size_t used;
+	int negative = 0;
+	*n = 0;
+	if (!length)
+		return -1;
+	switch (*s) {
+	case '$': base = 16; s++, length--; break;
+	case '#': base = 10; s++, length--; break;
+	case '%': base = 2;  s++, length--; break;
+	}
+	if (length && (*s == '-' || *s == '+')) {
+		negative = *s == '-';
+		s++, length--;
+	}
+	if ((base == 0 || base == 16) && length > 2 && s[0] == '0' && (s[1] | 0x20) == 'x') {
+		base = 16;
+		s += 2, length -= 2;
+	} else if (base == 0) {
+		base = length && s[0] == '0' ? 8 : 10;
+	}
+	used = forth_digits(base, n, s, length);
+	if (negative)
+		*n = -*n;
+	return !length || used != length;
 }
 
 /**
-The **match** function returns true if the word is not hidden and if
-a case sensitive case sensitive has succeeded.
-**/
-static int match(forth_cell_t *m, forth_cell_t pwd, const char *s)
-{
-	forth_cell_t len = WORD_LENGTH(m[pwd + 1]);
-	return !WORD_HIDDEN(m[pwd+1]) && !istrcmp(s, (char*)(&m[pwd-len]));
-}
+@brief This function turns a string into a number using a base and 
+returns an error code to indicate success or failure, the results of 
+the conversion are stored in **n**, even if the conversion failed.
 
-/** 
-**forth_find** finds a word in the dictionary and if it exists it returns a
-pointer to its **PWD** field. If it is not found it will return zero, also of
-notes is the fact that it will skip words that are hidden, that is the
-hidden bit in the **CODE** field of a word is set. The structure of the
-dictionary has already been explained, so there should be no surprises in
-this word. Any improvements to the speed of this word would speed up the
-text interpreter a lot, but not the virtual machine in general.
+The number can start with a prefix that overrides the base, **$** for
+hexadecimal, **#** for decimal and **%** for binary, followed by an 
+optional sign. A base of zero accepts numbers like C does, a leading
+**0x** means hexadecimal and a leading **0** means octal, otherwise they
+are decimal, a leading **0x** is also allowed when the base is sixteen.
+A number whose magnitude does not fit in a cell is not a number, negative
+numbers wrap around as they would with **negate**.
 **/
-forth_cell_t forth_find(forth_t *o, const char *s)
+int forth_string_to_cell(int base, forth_cell_t *n, const char *s)
 {
-	forth_cell_t *m = o->m, pwd = m[PWD];
-#ifdef USE_FAST_FIND
-	/* This implements a self organizing list, which speeds
-	 * up the searching of words (which has been profiled), however
-	 * it does not interact well with Forth words like "marker", so
-	 * it is optional. This method uses transposition, move to
-	 * front has not been tested.
-	 *
-	 * See: https://en.wikipedia.org/wiki/Self-organizing_list */
-	forth_cell_t grandparent = pwd, parent = pwd;
-	for (;pwd > DICTIONARY_START && !match(m, pwd, s);) {
-		grandparent = parent;
-		parent = pwd;
-		pwd = m[pwd];
-	}
-	if (pwd > DICTIONARY_START && parent != m[PWD]) { 
-		/* found - transpose it */
-		m[grandparent] = pwd; /* grandparent = current */
-		m[parent] = m[pwd];   /* parent = current next */
-		m[pwd] = parent;      /* new next = parent */
-	} 
-#else
-	for (;pwd > DICTIONARY_START && !match(m, pwd, s);)
-		pwd = m[pwd];
-#endif
-	return pwd > DICTIONARY_START ? pwd + 1 : 0;
+	return forth_number(base, n, s, strlen(s));
 }
 
 /**
-@brief Print a number in a given base to an output stream
-@param o    initialized forth environment
-@param out  output file stream
-@param u    number to print
-@return number of characters written, or negative on failure 
+**forth_string_to_double** turns a number ending in a decimal point, such
+as "1." or "-$ff.", into a double cell number, as the standard asks of
+the text interpreter. Only numbers whose magnitude fits in a cell are
+accepted, which are then sign extended.
 **/
-static int print_cell(forth_t *o, FILE *out, forth_cell_t u)
+static int forth_string_to_double(int base, forth_cell_t *lo, forth_cell_t *hi, const char *s)
 {
-	int i = 0, r = 0;
-	char s[64 + 1] = {0}; 
-	unsigned base = o->m[BASE];
-	base = base != 0 ? base : 10 ;
-	if (base >= 37)
+	size_t length = strlen(s);
+	int negative = s[0] == '-' || (s[0] && strchr("$#%", s[0]) && s[1] == '-');
+	*hi = 0;
+	if (length < 2 || s[length - 1] != '.' || forth_number(base, lo, s, length - 1))
 		return -1;
-	if (base == 10)
-		return fprintf(out, "%"PRIdCell, u);
-	do 
-		s[i++] = conv[u % base];
-	while ((u /= base));
-	for (r = --i; i >= 0; i--)
-		if (fputc(s[i], out) != s[i])
-			return -1;
-	return r;
+	*hi = negative && *lo ? (forth_cell_t)-1 : 0;
+	return 0;
 }
 
 /**
-**check_bounds** is used to both check that a memory access performed by
-the virtual machine is within range and as a crude method of debugging the
-interpreter (if it is enabled). The function is not called directly but is
-instead wrapped in with the **ck** macro, it can be removed with
-compile time defines, removing the check and the debugging code.
+@brief Bulk numeric input, reading delimited numbers straight into an
+array of cells, is done by **forth_parse_cells**, which is used by the
+**parse-cells** and **read-cells** instructions. Numbers are read as 
+they are by **READ**, and are separated by white space and at most one
+separator character, so both "1 2 3" and "1, 2,3" are three numbers when
+the separator is a comma, but ",1" and "1,,2" contain an empty field,
+which is an error. It stops at the end of the input, when **max** 
+numbers have been stored or at the start of a field that is not a 
+number, returning the number of characters used. **pending** is set if 
+a number has been read but not the separator after it, so the input can 
+be given to this function in pieces, as **forth_read_cells** does.
 **/
-static forth_cell_t check_bounds(forth_t *o, jmp_buf *on_error, 
-		forth_cell_t f, unsigned line, forth_cell_t bound)
+static inline int forth_is_space(int c)
 {
-	if (o->m[DEBUG] >= FORTH_DEBUG_CHECKS)
-		debug("0x%"PRIxCell " %u", f, line);
-	if (f >= bound) {
-		fatal("bounds check failed (%"PRIdCell" >= %zu) C line %u Forth Line %zu", 
-				f, (size_t)bound, line, o->line);
-		longjmp(*on_error, FATAL);
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static size_t forth_parse_cells(int base, const char *s, size_t length, 
+		forth_cell_t *cells, forth_cell_t *count, forth_cell_t max, 
+		int sep, int *pending)
+{
+	size_t i = 0, j;
+	for (;;) {
+		while (i < length && s[i] != sep && forth_is_space(s[i]))
+			i++;
+		if (i == length)
+			return i;
+		if (s[i] == sep) {
+			if (!*pending)
+				return i; /* empty field */
+			*pending = 0;
+			i++;
+			continue;
+		}
+		if (*count >= max)
+			return i;
+		for (j = i; j < length && s[j] != sep && !forth_is_space(s[j]); j++)
+			;
+		if (forth_number(base, &cells[*count], s + i, j - i))
+			return i;
+		(*count)++;
+		*pending = 1;
+		i = j;
 	}
-	return f;
 }
 
 /**
-**check_depth** is used to check that there are enough values on the stack
-before an operation takes place. It is wrapped up in the **cd** macro. 
+@brief **forth_read_cells** reads delimited numbers from a file into an 
+array of cells in blocks, never splitting a number between two calls to
+**forth_parse_cells**, and leaves the file positioned where it stopped
+reading numbers, if the file can be repositioned, so a field that is not
+a number can be found with **file-position**. It returns zero or an 
+*errno* value.
 **/
-static void check_depth(forth_t *o, jmp_buf *on_error, 
-		forth_cell_t *S, forth_cell_t expected, unsigned line)
+static int forth_read_cells(int base, FILE *file, forth_cell_t *cells, 
+		forth_cell_t *count, forth_cell_t max, int sep)
 {
-	if (o->m[DEBUG] >= FORTH_DEBUG_CHECKS)
-		debug("0x%"PRIxCell " %u", (forth_cell_t)(S - o->vstart), line);
-	if ((uintptr_t)(S - o->vstart) < expected) {
-		error("stack underflow %p -> %u (line %zu)", S - o->vstart, line, o->line);
-		longjmp(*on_error, RECOVERABLE);
-	} else if (S > o->vend) {
-		error("stack overflow %p -> %u (line %zu)", S - o->vend, line, o->line);
-		longjmp(*on_error, RECOVERABLE);
+	char buf[4096];
+	size_t have = 0, got, end, used;
+	int pending = 0, r;
+	errno = 0;
+	for (;;) {
+		got = fread(buf + have, 1, sizeof(buf) - have, file);
+		have += got;
+		end = have;
+		if (got) { /* leave any partial number for the next block */
+			while (end && buf[end - 1] != sep && !forth_is_space(buf[end - 1]))
+				end--;
+			if (!end)
+				end = have;
+		}
+		used = forth_parse_cells(base, buf, end, cells, count, max, sep, &pending);
+		if (used < end) {
+			r = ferror(file) ? ferrno() : 0;
+			if (fseek(file, -(long)(have - used), SEEK_CUR) < 0)
+				errno = 0; /* not a seekable file */
+			clearerr(file);
+			return r;
+		}
+		if (!got) {
+			r = ferror(file) ? ferrno() : 0;
+			clearerr(file);
+			return r;
+		}
+		memmove(buf, buf + end, have - end);
+		have -= end;
 	}
 }
 
 /**
-Check that the dictionary pointer does not go into the stack area:
+## Memory Primitives
+
+The memory instructions work on real addresses and mostly call the C
+library, whose versions of **memchr**, **memcmp**, **memmove** and 
+**memset** are already vectorised and pick the best instructions for the
+processor they run on. The following functions fill in the gaps, and the
+string words in *forth.fth* are built on top of them. Where the compiler
+targets SSE2, which all x86-64 processors have, the byte counting, case
+insensitive comparison and cell searching loops handle sixteen bytes at a
+time, the tail (and every other processor) uses the plain C version.
+
+**forth_memory_search** finds the first occurrence of one block of memory
+in another, using **memchr** to find candidates for **memcmp** to check.
 **/
-static forth_cell_t check_dictionary(forth_t *o, jmp_buf *on_error, 
-		forth_cell_t dptr)
+static const char *forth_memory_search(const char *s, size_t n, const char *p, size_t m)
 {
-	if ((o->m + dptr) >= (o->vstart)) {
-		fatal("dictionary pointer is in stack area %"PRIdCell, dptr);
-		forth_invalidate(o);
-		longjmp(*on_error, FATAL);
-	}
-	return dptr;
+	const char *end, *c;
+	if (!m)
+		return s;
+	if (m > n)
+		return NULL;
+	for (end = s + (n - m) + 1; s < end && (c = memchr(s, p[0], end - s)); s = c + 1)
+		if (!memcmp(c, p, m))
+			return c;
+	return NULL;
 }
 
 /**
-This checks that a Forth string is *NUL* terminated, as required by most C
-functions, which should be the last character in string (which is s+end).
-There is a bit of a mismatch between Forth strings (which are pointer to
-the string and a length) and C strings, which a pointer to the string and
-are *NUL* terminated. This function helps to correct that.
+**forth_memory_count** counts the bytes in a block of memory equal to a
+character. The SSE2 version keeps a count for each of the sixteen lanes in
+a register, which must be summed up before any lane can overflow.
 **/
-static void check_is_asciiz(jmp_buf *on_error, char *s, forth_cell_t end)
+static size_t forth_memory_count(const unsigned char *s, int c, size_t n)
 {
-	if (*(s + end) != '\0') {
-		error("not an ASCIIZ string at %p", s);
-		longjmp(*on_error, RECOVERABLE);
+	size_t i = 0, count = 0;
+#ifdef __SSE2__
+	const __m128i k = _mm_set1_epi8((char)c), zero = _mm_setzero_si128();
+	while (n - i >= 16) {
+		__m128i acc = zero;
+		size_t j, blocks = (n - i) / 16;
+		blocks = blocks > 255 ? 255 : blocks;
+		for (j = 0; j < blocks; j++, i += 16) {
+			__m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+			acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(x, k));
+		}
+		acc = _mm_sad_epu8(acc, zero);
+		count += _mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
 	}
+#endif
+	for (; i < n; i++)
+		count += s[i] == (unsigned char)c;
+	return count;
 }
 
 /**
-This function gets a string off the Forth stack, checking that the string
-is *NUL* terminated. It is a helper function used when a Forth string has to
-be converted to a C string so it can be passed to a C function.
+**forth_memory_icompare** compares two blocks of memory ignoring the case 
+of ASCII letters, like **memcmp** it returns a number less than, equal 
+to or greater than zero.
 **/
-static char *forth_get_string(forth_t *o, jmp_buf *on_error, 
-		forth_cell_t **S, forth_cell_t f)
+static inline int forth_lower(int c)
 {
-	forth_cell_t length = f + 1;
-	char *string = ((char*)o->m) + **S;
-	(*S)--;
-	check_is_asciiz(on_error, string, length);
-	return string;
+	return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
 }
 
-/** 
-Forth file access methods (or *fam*s) must be held in a single cell, this
-requires a method of translation from this cell into a string that can be
-used by the C function **fopen** 
-**/
-static const char* forth_get_fam(jmp_buf *on_error, forth_cell_t f)
+#ifdef __SSE2__
+static inline __m128i forth_lower_sse2(__m128i x)
 {
-	if (f >= LAST_FAM) {
+	const __m128i a = _mm_set1_epi8('A' - 1), z = _mm_set1_epi8('Z' + 1);
+	__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(x, a), _mm_cmplt_epi8(x, z));
+	return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+static int forth_memory_icompare(const unsigned char *a, const unsigned char *b, size_t n)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; n - i >= 16; i += 16) {
+		__m128i x = forth_lower_sse2(_mm_loadu_si128((const __m128i*)(a + i)));
+		__m128i y = forth_lower_sse2(_mm_loadu_si128((const __m128i*)(b + i)));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+			break; /* the scalar loop finds where they differ */
+	}
+#endif
+	for (; i < n; i++)
+		if (forth_lower(a[i]) != forth_lower(b[i]))
+			return forth_lower(a[i]) - forth_lower(b[i]);
+	return 0;
+}
+
+/**
+**forth_cells_set** and **forth_cells_locate** fill an array of cells with
+a value and find the first cell equal to a value, they are the cell sized
+versions of **memset** and **memchr**. SSE2 has no comparison for 64-bit
+lanes, so two 32-bit halves have to match, which is what swapping the
+halves of the comparison result and and-ing it with itself checks.
+**/
+static void forth_cells_set(forth_cell_t *c, forth_cell_t x, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		c[i] = x;
+}
+
+static forth_cell_t *forth_cells_locate(forth_cell_t *c, forth_cell_t x, size_t n)
+{
+	size_t i = 0;
+#if defined(__SSE2__) && UINTPTR_MAX == UINT64_MAX
+	const __m128i k = _mm_set1_epi64x((long long)x);
+	for (; n - i >= 4; i += 4) {
+		__m128i e0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(c + i)), k);
+		__m128i e1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(c + i + 2)), k);
+		e0 = _mm_and_si128(e0, _mm_shuffle_epi32(e0, _MM_SHUFFLE(2, 3, 0, 1)));
+		e1 = _mm_and_si128(e1, _mm_shuffle_epi32(e1, _MM_SHUFFLE(2, 3, 0, 1)));
+		if (_mm_movemask_epi8(_mm_or_si128(e0, e1)))
+			break; /* the scalar loop finds which one it is */
+	}
+#endif
+	for (; i < n; i++)
+		if (c[i] == x)
+			return c + i;
+	return NULL;
+}
+
+/**
+## Vector Primitives
+
+The vector instructions apply one of the **vector_operations** to whole
+arrays of cells, so numeric code goes through the dispatch loop once per
+array and not once per element. **forth_vector_op** defines what each
+operation does to a pair of cells, the rest are loops over it, with each
+operation getting its own copy of a loop from an X-Macro so the compiler
+can specialise and vectorise it. SSE2 has instructions for addition,
+subtraction and the bitwise operations on cell sized lanes, so those have
+hand written versions that handle sixteen bytes at a time, there is no
+SSE2 instruction for multiplying 64-bit lanes or for comparing them.
+
+A destination array may be the same as a source array, but it should
+not otherwise overlap with one.
+**/
+static inline forth_cell_t forth_vector_op(int op, forth_cell_t x, forth_cell_t y)
+{
+	switch (op) {
+	case VECTOR_ADD: return x + y;
+	case VECTOR_SUB: return x - y;
+	case VECTOR_MUL: return x * y;
+	case VECTOR_AND: return x & y;
+	case VECTOR_OR:  return x | y;
+	case VECTOR_XOR: return x ^ y;
+	case VECTOR_MIN: return (intptr_t)x < (intptr_t)y ? x : y;
+	case VECTOR_MAX: return (intptr_t)x > (intptr_t)y ? x : y;
+	}
+	return 0;
+}
+
+#ifdef __SSE2__
+#if UINTPTR_MAX == UINT64_MAX
+#define forth_set1_sse2(X) _mm_set1_epi64x((long long)(X))
+#define forth_add_sse2     _mm_add_epi64
+#define forth_sub_sse2     _mm_sub_epi64
+#else
+#define forth_set1_sse2(X) _mm_set1_epi32((int)(X))
+#define forth_add_sse2     _mm_add_epi32
+#define forth_sub_sse2     _mm_sub_epi32
+#endif
+#define FORTH_LANES (sizeof(__m128i) / sizeof(forth_cell_t))
+
+#define XMACRO_VECTOR_SSE2\
+ X(VECTOR_ADD, forth_add_sse2)\
+ X(VECTOR_SUB, forth_sub_sse2)\
+ X(VECTOR_AND, _mm_and_si128)\
+ X(VECTOR_OR,  _mm_or_si128)\
+ X(VECTOR_XOR, _mm_xor_si128)
+
+static forth_cell_t forth_lanes_sse2(__m128i x, int op)
+{
+	forth_cell_t t[FORTH_LANES], r;
+	_mm_storeu_si128((__m128i*)t, x);
+	r = t[0];
+	for (size_t j = 1; j < FORTH_LANES; j++)
+		r = forth_vector_op(op, r, t[j]);
+	return r;
+}
+#endif
+
+/**
+**forth_vector_map** computes *d[i] = a[i] op b[i]*, or *d[i] = a[i] op
+b[0]* if *step* is zero, which is how a single value is applied to every
+element.
+**/
+static void forth_vector_map(forth_cell_t *d, const forth_cell_t *a, 
+		const forth_cell_t *b, size_t step, size_t n, int op)
+{
+	size_t i = 0;
+	if (!n)
+		return;
+#ifdef __SSE2__
+	const __m128i k = forth_set1_sse2(b[0]);
+	switch (op) {
+#define X(ENUM, VOP) case ENUM:\
+		for (; n - i >= FORTH_LANES; i += FORTH_LANES) {\
+			__m128i x = _mm_loadu_si128((const __m128i*)(a + i));\
+			__m128i y = step ? _mm_loadu_si128((const __m128i*)(b + i)) : k;\
+			_mm_storeu_si128((__m128i*)(d + i), VOP(x, y));\
+		}\
+		break;
+	XMACRO_VECTOR_SSE2
+#undef X
+	}
+#endif
+	switch (op) {
+#define X(NAME, ENUM, DESCRIPTION) case ENUM:\
+		for (; i < n; i++)\
+			d[i] = forth_vector_op(ENUM, a[i], b[i * step]);\
+		break;
+	XMACRO_VECTOR_OPERATIONS
+#undef X
+	}
+}
+
+/**
+**forth_vector_reduce** folds an array from the left, *a[0] op a[1] op
+...*, an empty array reduces to zero. The SSE2 version keeps a partial
+result per lane, which only works for operations that can be regrouped,
+so not subtraction.
+**/
+static forth_cell_t forth_vector_reduce(const forth_cell_t *a, size_t n, int op)
+{
+	size_t i = 1;
+	forth_cell_t r;
+	if (!n)
+		return 0;
+	r = a[0];
+#ifdef __SSE2__
+	switch (op) {
+#define X(ENUM, VOP) case ENUM:\
+		if (ENUM != VECTOR_SUB && n >= 2 * FORTH_LANES) {\
+			__m128i acc = _mm_loadu_si128((const __m128i*)a);\
+			for (i = FORTH_LANES; n - i >= FORTH_LANES; i += FORTH_LANES)\
+				acc = VOP(acc, _mm_loadu_si128((const __m128i*)(a + i)));\
+			r = forth_lanes_sse2(acc, ENUM);\
+		}\
+		break;
+	XMACRO_VECTOR_SSE2
+#undef X
+	}
+#endif
+	switch (op) {
+#define X(NAME, ENUM, DESCRIPTION) case ENUM:\
+		for (; i < n; i++)\
+			r = forth_vector_op(ENUM, r, a[i]);\
+		break;
+	XMACRO_VECTOR_OPERATIONS
+#undef X
+	}
+	return r;
+}
+
+/**
+**forth_vector_scan** computes the running totals of an array, *d[i] = a[0]
+op ... op a[i]*, each element depends on the last so this is a plain loop.
+**forth_vector_dot** sums the products of two arrays, using four separate
+sums so the additions do not have to wait on each other.
+**/
+static void forth_vector_scan(forth_cell_t *d, const forth_cell_t *a, size_t n, int op)
+{
+	forth_cell_t r;
+	if (!n)
+		return;
+	d[0] = r = a[0];
+	switch (op) {
+#define X(NAME, ENUM, DESCRIPTION) case ENUM:\
+		for (size_t i = 1; i < n; i++)\
+			d[i] = r = forth_vector_op(ENUM, r, a[i]);\
+		break;
+	XMACRO_VECTOR_OPERATIONS
+#undef X
+	}
+}
+
+static forth_cell_t forth_vector_dot(const forth_cell_t *a, const forth_cell_t *b, size_t n)
+{
+	forth_cell_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+	size_t i = 0;
+	for (; n - i >= 4; i += 4) {
+		r0 += a[i]     * b[i];
+		r1 += a[i + 1] * b[i + 1];
+		r2 += a[i + 2] * b[i + 2];
+		r3 += a[i + 3] * b[i + 3];
+	}
+	for (; i < n; i++)
+		r0 += a[i] * b[i];
+	return r0 + r1 + r2 + r3;
+}
+
+/**
+## Sorting and Searching
+
+**forth_sort_cells** sorts an array of *n* records, each *width* cells
+long, by their first cell. It is a least significant digit first radix
+sort, a byte at a time, which is stable, so it can be used to sort pairs
+of keys and values, and it skips any byte that is the same in every key,
+so small numbers only take a pass or two. Signed numbers are sorted by
+flipping the sign bit of each key as it is looked at, which is what
+*bias* is for. Short arrays, and any array if there is no memory for the
+buffer the radix sort needs, are sorted by insertion instead.
+**/
+#define SIGN_BIT ((forth_cell_t)1 << (sizeof(forth_cell_t) * CHAR_BIT - 1))
+
+static void forth_sort_insertion(forth_cell_t *a, size_t n, size_t width, forth_cell_t bias)
+{
+	for (size_t i = 1; i < n; i++) {
+		forth_cell_t r[2];
+		size_t j;
+		memcpy(r, a + i * width, width * sizeof(*a));
+		for (j = i; j && (a[(j - 1) * width] ^ bias) > (r[0] ^ bias); j--)
+			memcpy(a + j * width, a + (j - 1) * width, width * sizeof(*a));
+		memcpy(a + j * width, r, width * sizeof(*a));
+	}
+}
+
+static void forth_sort_cells(forth_cell_t *a, size_t n, size_t width, forth_cell_t bias)
+{
+	forth_cell_t *from = a, *to, *buffer;
+	assert(width == 1 || width == 2);
+	if (n < 64 || !(buffer = malloc(n * width * sizeof(*a)))) {
+		forth_sort_insertion(a, n, width, bias);
+		return;
+	}
+	to = buffer;
+	for (unsigned shift = 0; shift < sizeof(*a) * CHAR_BIT; shift += CHAR_BIT) {
+		size_t count[UCHAR_MAX + 2] = { 0 };
+		for (size_t i = 0; i < n; i++)
+			count[(((from[i * width] ^ bias) >> shift) & UCHAR_MAX) + 1]++;
+		if (count[(((from[0] ^ bias) >> shift) & UCHAR_MAX) + 1] == n)
+			continue;
+		for (size_t d = 0; d <= UCHAR_MAX; d++)
+			count[d + 1] += count[d];
+		for (size_t i = 0; i < n; i++) {
+			size_t k = count[((from[i * width] ^ bias) >> shift) & UCHAR_MAX]++;
+			for (size_t c = 0; c < width; c++)
+				to[k * width + c] = from[i * width + c];
+		}
+		forth_cell_t *t = from;
+		from = to;
+		to = t;
+	}
+	if (from != a)
+		memcpy(a, from, n * width * sizeof(*a));
+	free(buffer);
+}
+
+/**
+**forth_search_cells** is a binary search of a sorted array, it returns
+the index of the first cell that is not less than *x*, which is where *x*
+would have to be inserted to keep the array sorted.
+**/
+static size_t forth_search_cells(const forth_cell_t *a, size_t n, forth_cell_t x, forth_cell_t bias)
+{
+	size_t lo = 0, hi = n;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if ((a[mid] ^ bias) < (x ^ bias))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+Sorting with a comparison written in Forth is harder, the comparison has
+to be run by the virtual machine, and calling back into **forth_run** for
+each one would be slow and complicated. Instead **forth_sort_step** is a
+heap sort turned inside out: each call carries on from where the last
+one stopped, using the result of the comparison it asked for, until it
+needs another comparison, whose arguments it returns the indices of. The
+state is kept in five cells on the variable stack, so the comparison is
+free to use anything else, including sorting another array. A heap sort
+was chosen because it needs no extra memory, but it is not stable.
+**/
+enum sort_state { 
+	SORT_END,   /**< size of the heap */
+	SORT_START, /**< next node to sift down whilst building the heap */
+	SORT_ROOT,  /**< node being sifted down */
+	SORT_CHILD, /**< child it is being compared with */
+	SORT_PHASE, /**< what to do next, one of **sort_phase** */
+	SORT_STATE_SIZE
+};
+
+enum sort_phase { SORT_NEXT, SORT_SIFT, SORT_CHILDREN, SORT_PARENT };
+
+static bool forth_sort_step(forth_cell_t *a, forth_cell_t *s, bool less, 
+		forth_cell_t *i, forth_cell_t *j)
+{
+	for (;;) {
+		switch (s[SORT_PHASE]) {
+		case SORT_NEXT:
+			if (s[SORT_START]) {
+				s[SORT_ROOT] = --s[SORT_START];
+			} else if (s[SORT_END] > 1) {
+				forth_cell_t t = a[0];
+				a[0] = a[--s[SORT_END]];
+				a[s[SORT_END]] = t;
+				s[SORT_ROOT] = 0;
+			} else {
+				return false;
+			}
+			s[SORT_PHASE] = SORT_SIFT;
+			break;
+		case SORT_SIFT:
+			s[SORT_CHILD] = 2 * s[SORT_ROOT] + 1;
+			if (s[SORT_CHILD] >= s[SORT_END]) {
+				s[SORT_PHASE] = SORT_NEXT;
+				break;
+			}
+			if (s[SORT_CHILD] + 1 < s[SORT_END]) {
+				s[SORT_PHASE] = SORT_CHILDREN;
+				*i = s[SORT_CHILD];
+				*j = s[SORT_CHILD] + 1;
+				return true;
+			}
+			s[SORT_PHASE] = SORT_PARENT;
+			*i = s[SORT_ROOT];
+			*j = s[SORT_CHILD];
+			return true;
+		case SORT_CHILDREN:
+			s[SORT_CHILD] += less;
+			s[SORT_PHASE] = SORT_PARENT;
+			*i = s[SORT_ROOT];
+			*j = s[SORT_CHILD];
+			return true;
+		case SORT_PARENT:
+			if (less) {
+				forth_cell_t t = a[s[SORT_ROOT]];
+				a[s[SORT_ROOT]] = a[s[SORT_CHILD]];
+				a[s[SORT_CHILD]] = t;
+				s[SORT_ROOT] = s[SORT_CHILD];
+				s[SORT_PHASE] = SORT_SIFT;
+			} else {
+				s[SORT_PHASE] = SORT_NEXT;
+			}
+			break;
+		default: /* the state has been trampled on */
+			return false;
+		}
+	}
+}
+
+/**
+The state is on the variable stack where anything can change it, so
+**forth_sort_valid** checks that the nodes it refers to in the phase it
+is in are within the heap, as **forth_sort_step** indexes the array
+with them. A heap that fits in the array is checked for separately.
+**/
+static bool forth_sort_valid(const forth_cell_t *s)
+{
+	if (s[SORT_START] > s[SORT_END])
+		return false;
+	switch (s[SORT_PHASE]) {
+	case SORT_NEXT:     return true;
+	case SORT_SIFT:     return s[SORT_ROOT] < s[SORT_END];
+	case SORT_CHILDREN: return s[SORT_ROOT] < s[SORT_END] 
+				&& s[SORT_CHILD] < s[SORT_END] - 1;
+	case SORT_PARENT:   return s[SORT_ROOT] < s[SORT_END] 
+				&& s[SORT_CHILD] < s[SORT_END];
+	default:            return true; /* finishes the sort */
+	}
+}
+
+/**
+## Checksums
+
+**forth_crc32c** and **forth_crc16** calculate a CRC32C (the Castagnoli
+polynomial, as used by iSCSI and ext4) and a CRC-16 with the CCITT 
+polynomial, *0x1021*, a byte at a time with a table. Processors with
+SSE4.2 have an instruction for CRC32C, which does eight bytes at a time,
+when compiling with GCC or Clang for x86-64 it is used if the processor
+running the interpreter has it. A CRC can be continued over more than one
+block of memory by passing in the result from the previous block, the
+CRC32C is inverted before and after, so that it starts from zero.
+
+The tables are constant, so that they can be shared by any number of
+Forth interpreters running in different threads. They were made a byte
+at a time, shifting each bit out and applying the polynomial when it is
+set, with the reversed polynomial *0x82F63B78* shifting right for the
+CRC32C and *0x1021* shifting left for the CRC-16.
+**/
+static const uint32_t crc32c_table[256] = {
+	0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
+	0x26a1e7e8, 0xd4ca64eb, 0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+	0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24, 0x105ec76f, 0xe235446c,
+	0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+	0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc,
+	0xbc267848, 0x4e4dfb4b, 0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+	0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35, 0xaa64d611, 0x580f5512,
+	0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+	0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad,
+	0x1642ae59, 0xe4292d5a, 0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+	0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595, 0x417b1dbc, 0xb3109ebf,
+	0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+	0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f,
+	0xed03a29b, 0x1f682198, 0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+	0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38, 0xdbfc821c, 0x2997011f,
+	0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+	0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e,
+	0x4767748a, 0xb50cf789, 0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+	0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46, 0x7198540d, 0x83f3d70e,
+	0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+	0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de,
+	0xdde0eb2a, 0x2f8b6829, 0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+	0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93, 0x082f63b7, 0xfa44e0b4,
+	0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+	0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b,
+	0xb4091bff, 0x466298fc, 0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+	0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033, 0xa24bb5a6, 0x502036a5,
+	0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+	0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975,
+	0x0e330a81, 0xfc588982, 0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+	0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622, 0x38cc2a06, 0xcaa7a905,
+	0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+	0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8,
+	0xe52cc12c, 0x1747422f, 0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+	0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0, 0xd3d3e1ab, 0x21b862a8,
+	0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+	0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78,
+	0x7fab5e8c, 0x8dc0dd8f, 0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+	0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1, 0x69e9f0d5, 0x9b8273d6,
+	0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+	0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69,
+	0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+	0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+static const uint16_t crc16_table[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+	0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+	0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+	0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+	0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+	0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+	0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+	0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+	0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+	0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+	0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+	0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+	0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+	0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+	0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+	0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+	0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+	0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+	0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+	0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+	0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+	0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+	0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
+};
+
+#if defined(__GNUC__) && defined(__x86_64__)
+__attribute__((target("sse4.2")))
+static uint32_t forth_crc32c_sse42(uint32_t c, const unsigned char *s, size_t n)
+{
+	uint64_t c64 = c;
+	for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t), s += sizeof(uint64_t)) {
+		uint64_t x;
+		memcpy(&x, s, sizeof(x));
+		c64 = _mm_crc32_u64(c64, x);
+	}
+	c = c64;
+	for (; n; n--)
+		c = _mm_crc32_u8(c, *s++);
+	return c;
+}
+#endif
+
+static uint32_t forth_crc32c(uint32_t c, const void *p, size_t n)
+{
+	const unsigned char *s = p;
+	c = ~c;
+#if defined(__GNUC__) && defined(__x86_64__)
+	if (__builtin_cpu_supports("sse4.2"))
+		return ~forth_crc32c_sse42(c, s, n);
+#endif
+	for (; n; n--)
+		c = crc32c_table[(c ^ *s++) & 0xFFu] ^ (c >> 8);
+	return ~c;
+}
+
+static uint16_t forth_crc16(uint16_t c, const void *p, size_t n)
+{
+	const unsigned char *s = p;
+	for (; n; n--)
+		c = (c << 8) ^ crc16_table[((c >> 8) ^ *s++) & 0xFFu];
+	return c;
+}
+
+/**
+## Double Cell Arithmetic
+
+A double cell number is held on the stack as two cells, with the most
+significant cell on top. Multiplying two cells needs a double cell
+result if nothing is to be lost, and dividing a double cell number by a
+cell is what pictured numeric output and the scaling words are built
+upon, so these are done in C.
+
+If the compiler has an unsigned integer type twice the width of a cell
+then it does the work, otherwise multiplication is done long hand on half
+cells and division by shifting and subtracting a bit at a time.
+**/
+#define CELL_BITS (sizeof(forth_cell_t) * CHAR_BIT)
+
+#if defined(__SIZEOF_INT128__) && UINTPTR_MAX == UINT64_MAX
+__extension__ typedef unsigned __int128 forth_dcell_t;
+#define FORTH_DCELL
+#elif UINTPTR_MAX == UINT32_MAX
+typedef uint64_t forth_dcell_t;
+#define FORTH_DCELL
+#endif
+
+/**
+**forth_umul** multiplies two unsigned cells, it returns the least
+significant cell of the product and stores the most significant in *hi*.
+**/
+static forth_cell_t forth_umul(forth_cell_t a, forth_cell_t b, forth_cell_t *hi)
+{
+#ifdef FORTH_DCELL
+	forth_dcell_t r = (forth_dcell_t)a * b;
+	*hi = (forth_cell_t)(r >> CELL_BITS);
+	return (forth_cell_t)r;
+#else
+	const unsigned half = CELL_BITS / 2;
+	const forth_cell_t mask = ((forth_cell_t)1 << half) - 1;
+	forth_cell_t al = a & mask, ah = a >> half, bl = b & mask, bh = b >> half;
+	forth_cell_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+	forth_cell_t mid = (ll >> half) + (lh & mask) + (hl & mask);
+	*hi = hh + (lh >> half) + (hl >> half) + (mid >> half);
+	return (mid << half) | (ll & mask);
+#endif
+}
+
+/**
+**forth_mul** is the signed version of **forth_umul**, the unsigned
+product only needs its top half correcting for negative arguments.
+**/
+static forth_cell_t forth_mul(forth_cell_t a, forth_cell_t b, forth_cell_t *hi)
+{
+	forth_cell_t lo = forth_umul(a, b, hi);
+	*hi -= (a & SIGN_BIT ? b : 0) + (b & SIGN_BIT ? a : 0);
+	return lo;
+}
+
+/**
+**forth_umdiv** divides the double cell number *hi* and *lo* by *d*,
+returning the remainder and storing the quotient in *quot*. The caller
+must make sure that *d* is not zero and that the quotient fits in a
+cell, which is the case if *hi* is less than *d*.
+**/
+static forth_cell_t forth_umdiv(forth_cell_t lo, forth_cell_t hi, forth_cell_t d, forth_cell_t *quot)
+{
+	assert(d && hi < d);
+#ifdef FORTH_DCELL
+	forth_dcell_t n = ((forth_dcell_t)hi << CELL_BITS) | lo;
+	*quot = (forth_cell_t)(n / d);
+	return (forth_cell_t)(n % d);
+#else
+	forth_cell_t q = 0;
+	for (unsigned i = 0; i < CELL_BITS; i++) {
+		forth_cell_t carry = hi >> (CELL_BITS - 1);
+		hi = (hi << 1) | (lo >> (CELL_BITS - 1));
+		lo <<= 1;
+		q <<= 1;
+		if (carry || hi >= d) {
+			hi -= d;
+			q |= 1;
+		}
+	}
+	*quot = q;
+	return hi;
+#endif
+}
+
+/**
+**forth_smdiv** divides the signed double cell number *hi* and *lo* by
+the signed cell *n*, it works on the magnitudes with **forth_umdiv** and
+fixes up the signs afterwards. The quotient is rounded towards zero
+unless *floored* is true, in which case it is rounded towards negative
+infinity, as **sm/rem** and **fm/mod** require. It returns zero or the
+error to throw.
+**/
+static int forth_smdiv(forth_cell_t lo, forth_cell_t hi, forth_cell_t n, 
+		bool floored, forth_cell_t *rem, forth_cell_t *quot)
+{
+	const bool negative = hi & SIGN_BIT, sign = negative != !!(n & SIGN_BIT);
+	const forth_cell_t d = n & SIGN_BIT ? -n : n;
+	forth_cell_t q, r;
+	if (!d)
+		return THROW_DIVISION_BY_ZERO;
+	if (negative) {
+		lo = -lo;
+		hi = ~hi + !lo;
+	}
+	if (hi >= d)
+		return THROW_RESULT_OUT_OF_RANGE;
+	r = forth_umdiv(lo, hi, d, &q);
+	floored = floored && sign && r;
+	if (q > (sign ? SIGN_BIT - floored : SIGN_BIT - 1))
+		return THROW_RESULT_OUT_OF_RANGE;
+	q = sign ? -q : q;
+	r = negative ? -r : r;
+	if (floored) {
+		q--;
+		r += n;
+	}
+	*rem = r;
+	*quot = q;
+	return 0;
+}
+
+/**
+## Floating Point
+
+Floating point numbers are IEEE-754 doubles, stored in the core in
+**FLOAT_CELLS** cells, which may not be aligned well enough to be
+accessed as a **double** directly, so they are copied in and out.
+**/
+static double forth_float_load(const forth_cell_t *m, forth_cell_t addr)
+{
+	double r;
+	memcpy(&r, m + addr, sizeof(r));
+	return r;
+}
+
+static void forth_float_save(forth_cell_t *m, forth_cell_t addr, double r)
+{
+	memcpy(m + addr, &r, sizeof(r));
+}
+
+/**
+**forth_string_to_float** turns a string into a floating point number,
+returning non zero if it is not one. When it is *strict*, as it is for
+the literals read in by the interpreter, the number must contain an
+exponent so it cannot be mistaken for an integer or a double cell number
+such as "1.", as in "1.5e0", "-2e3" or "1.5E", an exponent with no digits
+being allowed by the standard. Otherwise, for **>float**, the exponent
+is optional and a string of blanks is zero. Only the characters that
+make up a number are accepted, so words like "inf" are not numbers.
+
+The number is checked here and only then handed to *strtod*, which
+expects the decimal point of the current locale, so the point is swapped
+for that one; a program embedding this library might have called
+*setlocale* and the source code should not change meaning because of it.
+**/
+static int forth_string_to_float(double *r, const char *s, size_t length, bool strict)
+{
+	char buf[64];
+	const char *point = localeconv()->decimal_point;
+	size_t i = 0, j = 0, end, digits = 0, dot = length, plen = strlen(point);
+	int exponent = 0;
+	if (!strict) {
+		for (; i < length && s[i] == ' '; i++)
+			;
+		if (i == length) {
+			*r = 0.0;
+			return 0;
+		}
+		i = 0;
+	}
+	if (i < length && (s[i] == '-' || s[i] == '+'))
+		i++;
+	for (; i < length && isdigit((unsigned char)s[i]); i++)
+		digits++;
+	if (i < length && s[i] == '.')
+		for (dot = i++; i < length && isdigit((unsigned char)s[i]); i++)
+			digits++;
+	if (!digits)
+		return -1;
+	end = i;
+	if (i < length && (s[i] | 0x20) == 'e') {
+		exponent = 1;
+		if (++i < length && (s[i] == '-' || s[i] == '+'))
+			i++;
+		if (i < length && isdigit((unsigned char)s[i])) {
+			while (i < length && isdigit((unsigned char)s[i]))
+				i++;
+			end = i;
+		}
+	}
+	if ((strict && !exponent) || i != length || end + plen >= sizeof(buf))
+		return -1;
+	for (i = 0; i < end; i++) {
+		if (i == dot) {
+			memcpy(buf + j, point, plen);
+			j += plen;
+		} else {
+			buf[j++] = s[i];
+		}
+	}
+	buf[j] = '\0';
+	*r = strtod(buf, NULL);
+	return 0;
+}
+
+/**
+**forth_float_print** prints a number for **f.**, in the fixed point
+notation the standard asks for, or for **fs.** in scientific notation,
+with as many digits as **precision** says are significant. For **f.**
+how many of those fall after the point depends on the decimal exponent,
+which is taken from *printf* so it is rounded the same way the digits
+are. Trailing zeros are dropped but the point is kept, so "1.5e0" prints
+as "1.5" and "1e20" as "100000000000000000000.". *printf* uses the
+decimal point of the current locale, which is swapped back for a '.'
+so numbers are printed the way **forth_string_to_float** reads them.
+**/
+static void forth_float_print(FILE *out, double r, int precision, bool scientific)
+{
+	char buf[512], *e;
+	const char *point = localeconv()->decimal_point;
+	const size_t plen = strlen(point);
+	int places = 0;
+	if (precision < 1)
+		precision = 1;
+	if (precision > DBL_DIG + 2)
+		precision = DBL_DIG + 2;
+	if (scientific) {
+		snprintf(buf, sizeof(buf), "%.*e", precision - 1, r);
+	} else {
+		if (isfinite(r) && r != 0.0) {
+			snprintf(buf, sizeof(buf), "%.*e", precision - 1, r);
+			if ((e = strchr(buf, 'e')))
+				places = precision - 1 - atoi(e + 1);
+		}
+		if (places < 0)
+			places = 0;
+		snprintf(buf, sizeof(buf), "%#.*f", places, r);
+		if (isfinite(r)) {
+			size_t l = strlen(buf);
+			while (l > 1 && buf[l - 1] == '0')
+				buf[--l] = '\0';
+		}
+	}
+	if (strcmp(point, ".") && plen && (e = strstr(buf, point))) {
+		*e = '.';
+		memmove(e + 1, e + plen, strlen(e + plen) + 1);
+	}
+	fprintf(out, "%s ", buf);
+}
+
+/**
+**forth_float_to_double_cell** converts a floating point number to a
+signed double cell number, rounding towards zero, which **f>d** needs.
+Numbers that fit in a cell are converted directly, and for larger ones
+the most significant cell is split off by scaling.
+**/
+static forth_cell_t forth_float_to_double_cell(double r, forth_cell_t *hi)
+{
+	double t = trunc(r), h;
+	if (fabs(t) < ldexp(1.0, CELL_BITS - 1)) {
+		*hi = t < 0 ? (forth_cell_t)-1 : 0;
+		return (forth_cell_t)(intptr_t)t;
+	}
+	h = floor(ldexp(t, -(int)CELL_BITS));
+	*hi = (forth_cell_t)(intptr_t)h;
+	return (forth_cell_t)(t - ldexp(h, CELL_BITS));
+}
+
+/**
+## Arbitrary Precision Integers
+
+A bignum lives in the core, it is a cell holding its capacity in cells,
+a cell holding the number of cells in use, with the sign held in the top
+bit, followed by the magnitude, least significant cell first:
+
+	.----------.------------.----------.----------.-----
+	| CAPACITY | SIGN, SIZE | LIMB 0   | LIMB 1   | ...
+	.----------.------------.----------.----------.-----
+
+The most significant limb in use is never zero and zero is never
+negative. The functions here work on the magnitudes, as arrays of limbs,
+and the **(bignum)** instruction deals with signs and with storing the
+results. Results are built in memory from **malloc** and then copied into
+their destination, so a destination may also be one of the arguments, and
+a result that does not fit in its destination throws -11.
+
+Multiplication switches from the schoolbook method to Karatsuba's method
+once both numbers are **BIG_KARATSUBA** limbs long, and division is
+Knuth's algorithm D, which uses **forth_umdiv** to estimate each limb of
+the quotient.
+**/
+#define BIG_KARATSUBA (32u)
+
+enum bignum {
+	BIG_CAPACITY, /**< limbs the bignum has room for */
+	BIG_SIZE,     /**< limbs in use, and the sign in the top bit */
+	BIG_LIMBS     /**< the magnitude, least significant limb first */
+};
+
+static size_t big_trim(const forth_cell_t *a, size_t n)
+{
+	while (n && !a[n - 1])
+		n--;
+	return n;
+}
+
+static int big_compare_magnitude(const forth_cell_t *a, size_t an, const forth_cell_t *b, size_t bn)
+{
+	if (an != bn)
+		return an < bn ? -1 : 1;
+	while (an--)
+		if (a[an] != b[an])
+			return a[an] < b[an] ? -1 : 1;
+	return 0;
+}
+
+/**
+**big_add_into** adds *x* to *r*, where *x* is no longer than *r*, and
+**big_sub_into** subtracts it, they return the carry or borrow out of
+the top of *r*.
+**/
+static forth_cell_t big_add_into(forth_cell_t *r, size_t rn, const forth_cell_t *x, size_t xn)
+{
+	forth_cell_t carry = 0;
+	assert(xn <= rn);
+	for (size_t i = 0; i < rn && (i < xn || carry); i++) {
+		forth_cell_t y = i < xn ? x[i] : 0, s = r[i] + y;
+		forth_cell_t c = s < y;
+		r[i] = s + carry;
+		carry = c + (r[i] < s);
+	}
+	return carry;
+}
+
+static forth_cell_t big_sub_into(forth_cell_t *r, size_t rn, const forth_cell_t *x, size_t xn)
+{
+	forth_cell_t borrow = 0;
+	assert(xn <= rn);
+	for (size_t i = 0; i < rn && (i < xn || borrow); i++) {
+		forth_cell_t y = i < xn ? x[i] : 0, d = r[i] - y;
+		forth_cell_t b = r[i] < y;
+		r[i] = d - borrow;
+		borrow = b + (d < borrow);
+	}
+	return borrow;
+}
+
+static void big_mul_school(forth_cell_t *r, const forth_cell_t *a, size_t an, const forth_cell_t *b, size_t bn)
+{
+	memset(r, 0, (an + bn) * sizeof(*r));
+	for (size_t i = 0; i < an; i++) {
+		forth_cell_t carry = 0;
+		for (size_t j = 0; j < bn; j++) {
+			forth_cell_t hi, lo = forth_umul(a[i], b[j], &hi);
+			lo += carry;
+			hi += lo < carry;
+			r[i + j] += lo;
+			hi += r[i + j] < lo;
+			carry = hi;
+		}
+		r[i + bn] = carry;
+	}
+}
+
+/**
+**big_mul** multiplies *a* by *b* giving *an + bn* limbs in *r*, which
+must not overlap either of them. Karatsuba's method splits both numbers
+in two at *h* limbs and makes do with three half sized multiplications
+instead of four, the middle product is made from the sums of the halves,
+less the two outer products. A number that is too short to be split
+at the same place as the other one is multiplied in pieces instead. If 
+memory for the intermediate results cannot be had the schoolbook method
+is used, which needs none.
+**/
+static void big_mul(forth_cell_t *r, const forth_cell_t *a, size_t an, const forth_cell_t *b, size_t bn)
+{
+	forth_cell_t *t;
+	if (an < bn) {
+		const forth_cell_t *x = a;
+		size_t xn = an;
+		a = b, an = bn;
+		b = x, bn = xn;
+	}
+	if (bn < BIG_KARATSUBA) {
+		big_mul_school(r, a, an, b, bn);
+		return;
+	}
+	const size_t h = an / 2;
+	if (bn <= h) {
+		if (!(t = malloc((an - h + bn) * sizeof(*t)))) {
+			big_mul_school(r, a, an, b, bn);
+			return;
+		}
+		big_mul(r, a, h, b, bn);
+		memset(r + h + bn, 0, (an - h) * sizeof(*r));
+		big_mul(t, a + h, an - h, b, bn);
+		big_add_into(r + h, an + bn - h, t, an - h + bn);
+		free(t);
+		return;
+	}
+	const size_t a1n = an - h, b1n = bn - h;
+	const size_t san = a1n + 1, sbn = (b1n > h ? b1n : h) + 1, zn = san + sbn;
+	if (!(t = malloc((san + sbn + zn) * sizeof(*t)))) {
+		big_mul_school(r, a, an, b, bn);
+		return;
+	}
+	forth_cell_t *sa = t, *sb = t + san, *z = t + san + sbn;
+	big_mul(r, a, h, b, h);
+	big_mul(r + 2 * h, a + h, a1n, b + h, b1n);
+	memset(sa, 0, (san + sbn) * sizeof(*t));
+	memcpy(sa, a + h, a1n * sizeof(*t));
+	big_add_into(sa, san, a, h);
+	memcpy(sb, b + h, b1n * sizeof(*t));
+	big_add_into(sb, sbn, b, h);
+	big_mul(z, sa, san, sb, sbn);
+	big_sub_into(z, zn, r, 2 * h);
+	big_sub_into(z, zn, r + 2 * h, a1n + b1n);
+	big_add_into(r + h, an + bn - h, z, big_trim(z, zn));
+	free(t);
+}
+
+/**
+**big_divide** divides *u* by *v*, which has no leading zero limbs and
+is no longer than *u*, giving *un - vn + 1* limbs of quotient in *q* and
+*vn* limbs of remainder in *r*. It returns non zero if it could not get
+the memory it needs.
+**/
+static int big_divide(forth_cell_t *q, forth_cell_t *r, const forth_cell_t *u, size_t un, const forth_cell_t *v, size_t vn)
+{
+	forth_cell_t *nu, *nv;
+	unsigned s = 0;
+	assert(vn && v[vn - 1] && un >= vn);
+	if (vn == 1) {
+		forth_cell_t rem = 0;
+		for (size_t i = un; i--;)
+			rem = forth_umdiv(u[i], rem, v[0], &q[i]);
+		r[0] = rem;
+		return 0;
+	}
+	if (!(nu = malloc((un + 1 + vn) * sizeof(*nu))))
+		return -1;
+	nv = nu + un + 1;
+	for (forth_cell_t x = v[vn - 1]; !(x & SIGN_BIT); x <<= 1)
+		s++;
+	for (size_t i = vn; i--;)
+		nv[i] = (v[i] << s) | (s && i ? v[i - 1] >> (CELL_BITS - s) : 0);
+	nu[un] = s ? u[un - 1] >> (CELL_BITS - s) : 0;
+	for (size_t i = un; i--;)
+		nu[i] = (u[i] << s) | (s && i ? u[i - 1] >> (CELL_BITS - s) : 0);
+	for (size_t j = un - vn + 1; j--;) {
+		forth_cell_t qhat, rhat, hi, lo, borrow = 0, carry = 0;
+		bool big = false;
+		if (nu[j + vn] >= nv[vn - 1]) {
+			qhat = (forth_cell_t)-1;
+			rhat = nu[j + vn - 1] + nv[vn - 1];
+			big = rhat < nv[vn - 1];
+		} else {
+			rhat = forth_umdiv(nu[j + vn - 1], nu[j + vn], nv[vn - 1], &qhat);
+		}
+		while (!big) {
+			lo = forth_umul(qhat, nv[vn - 2], &hi);
+			if (hi < rhat || (hi == rhat && lo <= nu[j + vn - 2]))
+				break;
+			qhat--;
+			rhat += nv[vn - 1];
+			big = rhat < nv[vn - 1];
+		}
+		for (size_t i = 0; i < vn; i++) {
+			lo = forth_umul(qhat, nv[i], &hi);
+			lo += carry;
+			hi += lo < carry;
+			forth_cell_t d = nu[i + j] - lo, b = nu[i + j] < lo;
+			nu[i + j] = d - borrow;
+			borrow = b + (d < borrow);
+			carry = hi;
+		}
+		forth_cell_t d = nu[j + vn] - carry, b = nu[j + vn] < carry;
+		nu[j + vn] = d - borrow;
+		if (b + (d < borrow)) { /* qhat was one too big, add v back */
+			qhat--;
+			nu[j + vn] += big_add_into(nu + j, vn, nv, vn);
+		}
+		q[j] = qhat;
+	}
+	for (size_t i = 0; i < vn; i++)
+		r[i] = (nu[i] >> s) | (s ? nu[i + 1] << (CELL_BITS - s) : 0);
+	free(nu);
+	return 0;
+}
+
+/**
+**big_reduce** replaces *x*, of *xn* limbs, by its remainder modulo *m*,
+returning the number of limbs left, or zero if memory could not be had.
+It is used by modular exponentiation, where *x* is never zero.
+**/
+static size_t big_reduce(forth_cell_t *x, size_t xn, const forth_cell_t *m, size_t mn)
+{
+	forth_cell_t *q;
+	if ((xn = big_trim(x, xn)) < mn)
+		return xn ? xn : 1;
+	if (!(q = malloc((xn - mn + 1) * sizeof(*q))))
+		return 0;
+	if (big_divide(q, x, x, xn, m, mn))
+		xn = 0;
+	else
+		xn = big_trim(x, mn);
+	free(q);
+	return xn ? xn : 1; 
+}
+
+/**
+**big_to_string** writes the magnitude of *a* in *base* to *s*, which
+has room for *max* characters, and returns the number of characters
+used, or *max + 1* if there was not enough room. The limbs are divided 
+by the largest power of the base that fits in a cell so that each long 
+division yields a whole cell of digits.
+**/
+static size_t big_to_string(char *s, size_t max, const forth_cell_t *a, size_t an, unsigned base)
+{
+	forth_cell_t *x, chunk = base;
+	size_t digits = 1, n = 0;
+	while (chunk <= ((forth_cell_t)-1) / base)
+		chunk *= base, digits++;
+	if (!an) {
+		if (max)
+			s[0] = '0';
+		return max ? 1 : 1 + max;
+	}
+	if (!(x = malloc(an * sizeof(*x))))
+		return max + 1;
+	memcpy(x, a, an * sizeof(*x));
+	while (an) {
+		forth_cell_t rem = 0;
+		for (size_t i = an; i--;)
+			rem = forth_umdiv(x[i], rem, chunk, &x[i]);
+		an = big_trim(x, an);
+		for (size_t i = 0; i < digits && (an || rem); i++, rem /= base) {
+			if (n >= max) {
+				free(x);
+				return max + 1;
+			}
+			s[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[rem % base];
+		}
+	}
+	free(x);
+	for (size_t i = 0; i < n / 2; i++) {
+		char c = s[i];
+		s[i] = s[n - i - 1];
+		s[n - i - 1] = c;
+	}
+	return n;
+}
+
+/**
+**big_from_string** reads a number in *base* into the *max* limbs at *a*,
+returning the number of limbs used, or -1 if the string is not a number
+and -2 if it does not fit. Digits are gathered up into a cell at a time
+before being added in.
+**/
+static long big_from_string(forth_cell_t *a, size_t max, const char *s, size_t length, unsigned base)
+{
+	size_t an = 0, i = 0;
+	if (!length)
+		return -1;
+	while (i < length) {
+		forth_cell_t chunk = 0, scale = 1;
+		size_t used;
+		for (used = 0; i < length && scale <= ((forth_cell_t)-1) / base; used++, i++) {
+			int c = (unsigned char)s[i];
+			unsigned d = 
+				c >= '0' && c <= '9' ? (unsigned)(c - '0') :
+				(c | 0x20) >= 'a' && (c | 0x20) <= 'z' ? (unsigned)((c | 0x20) - 'a' + 10) : 36;
+			if (d >= base)
+				return -1;
+			chunk = chunk * base + d;
+			scale *= base;
+		}
+		forth_cell_t carry = chunk;
+		for (size_t j = 0; j < an; j++) {
+			forth_cell_t hi, lo = forth_umul(a[j], scale, &hi);
+			lo += carry;
+			hi += lo < carry;
+			a[j] = lo;
+			carry = hi;
+		}
+		if (carry) {
+			if (an >= max)
+				return -2;
+			a[an++] = carry;
+		}
+	}
+	return an;
+}
+
+/**
+## Regular Expressions
+
+A regular expression is compiled into a small program for a Thompson NFA,
+which is run in the manner of Pike's virtual machine; every state the
+machine could be in is stepped forward together over each character of the
+string, so no backtracking is ever done. This takes time proportional to
+the length of the string multiplied by the length of the program whatever
+the pattern, where a backtracking matcher can take exponential time. The
+language understood is:
+
+	c        match the character 'c'
+	.        match any character
+	[abc]    match any character in a set, ranges such as 'a-z' are
+	         allowed, and '[^abc]' matches any character not in the set
+	\d \w \s match a digit, a word character or white space, the upper
+	         case versions match any other character
+	\n \t \r match a new line, tab or carriage return
+	\c       match 'c', if it is not a letter or a digit
+	^ $      match the start or end of the string
+	e*       match 'e' zero or more times
+	e+       match 'e' one or more times
+	e?       match 'e' zero or one times
+	e{n,m}   match 'e' between n and m times, 'e{n}' and 'e{n,}' are
+	         allowed as well
+	e1|e2    match 'e1' or 'e2'
+	(e)      match 'e' and capture what it matched as a group
+	(?:e)    match 'e' without capturing it
+
+A repetition followed by a '?' matches as little as it can instead of as
+much. Where a string can be matched in more than one way, the match a
+backtracking matcher would find first is chosen.
+
+A compiled regular expression lives in the core, so it can be reused, and
+it is saved with the core. It is a header, the captures of the last
+successful match, and the program:
+
+	.------.--------.-------.--------------.-------------
+	| SIZE | GROUPS | FIRST | CAPTURES ... | PROGRAM ...
+	.------.--------.-------.--------------.-------------
+
+*SIZE* is the number of cells it takes up, *GROUPS* the number of groups,
+including the whole match as group zero, and *FIRST* a character every
+match must begin with, or -1 if there is not one, which lets a search skip
+ahead with **memchr**. Each group has two captures, the address of its
+first character and the address after its last, both are -1 if the group
+took no part in the match.
+
+The instructions of the program are a cell holding the instruction
+followed by its arguments. Jumps are relative to the instruction they are
+in, so a compiled fragment of a program can be moved or copied without
+changing it, which is how repetitions and alternations are compiled as
+the pattern is parsed, by inserting instructions in front of fragments or
+copying them. As the core can be written to, a program is checked before
+it is run.
+**/
+#define RX_CLASS_CELLS (256u / CELL_BITS) /**< cells in a character set */
+#define RX_MAX_REPEAT  (1000u) /**< largest count allowed in 'e{n,m}' */
+#define RX_MAX_DEPTH   (64u)   /**< deepest nesting of groups allowed */
+
+enum regex {
+	REGEX_SIZE,    /**< cells the regular expression takes up */
+	REGEX_GROUPS,  /**< groups, including the whole match */
+	REGEX_FIRST,   /**< character every match starts with, or -1 */
+	REGEX_CAPTURES /**< captures of the last match, then the program */
+};
+
+enum regex_instructions {
+	RX_CHAR,  /**< match the character that follows */
+	RX_ANY,   /**< match any character */
+	RX_CLASS, /**< match a character in the set that follows */
+	RX_SPLIT, /**< carry on at both of the offsets that follow */
+	RX_JUMP,  /**< carry on at the offset that follows */
+	RX_SAVE,  /**< save the position in the capture that follows */
+	RX_BOL,   /**< match the start of the string */
+	RX_EOL,   /**< match the end of the string */
+	RX_MATCH, /**< the regular expression has matched */
+	LAST_RX_INSTRUCTION
+};
+
+static size_t rx_length(forth_cell_t op)
+{
+	switch (op) {
+	case RX_CHAR: case RX_JUMP: case RX_SAVE: return 2;
+	case RX_SPLIT: return 3;
+	case RX_CLASS: return 1 + RX_CLASS_CELLS;
+	default: return 1;
+	}
+}
+
+static bool rx_in_class(const forth_cell_t *set, unsigned char ch)
+{
+	return (set[ch / CELL_BITS] >> (ch % CELL_BITS)) & 1;
+}
+
+static void rx_add_to_class(forth_cell_t *set, unsigned lo, unsigned hi)
+{
+	for (; lo <= hi; lo++)
+		set[lo / CELL_BITS] |= (forth_cell_t)1 << (lo % CELL_BITS);
+}
+
+/**
+**rx_escape_class** adds the set for the escape '\d', '\w' or '\s', or
+their opposites, to *set*, returning false if *e* is not one of them.
+**/
+static bool rx_escape_class(forth_cell_t *set, char e)
+{
+	forth_cell_t t[RX_CLASS_CELLS] = { 0 };
+	switch (e | 0x20) {
+	case 'd': 
+		rx_add_to_class(t, '0', '9'); 
+		break;
+	case 'w': 
+		rx_add_to_class(t, '0', '9'); 
+		rx_add_to_class(t, 'a', 'z'); 
+		rx_add_to_class(t, 'A', 'Z'); 
+		rx_add_to_class(t, '_', '_'); 
+		break;
+	case 's': 
+		rx_add_to_class(t, '\t', '\r'); 
+		rx_add_to_class(t, ' ', ' '); 
+		break;
+	default: 
+		return false;
+	}
+	for (size_t i = 0; i < RX_CLASS_CELLS; i++)
+		set[i] |= (e & 0x20) ? t[i] : ~t[i];
+	return true;
+}
+
+static int rx_escape_char(char e)
+{
+	switch (e) {
+	case 'n': return '\n';
+	case 't': return '\t';
+	case 'r': return '\r';
+	}
+	return isalnum((unsigned char)e) ? -1 : (unsigned char)e;
+}
+
+/**
+The compiler is a recursive descent parser that writes the program as it
+goes. *error* is set to the reason compilation failed, and *full* if it
+failed because the program did not fit.
+**/
+struct regex_compiler {
+	const char *start, *p, *end; /**< the pattern and where we are in it */
+	forth_cell_t *code; /**< the program being compiled */
+	size_t n, max;      /**< cells used, and cells there is room for */
+	forth_cell_t groups; /**< groups so far, including the whole match */
+	unsigned depth;     /**< nesting of groups */
+	const char *error;  /**< why compilation failed, or NULL */
+	bool full;          /**< the program did not fit in *max* cells */
+};
+
+static bool rx_fail(struct regex_compiler *c, const char *error)
+{
+	if (!c->error)
+		c->error = error;
+	return false;
+}
+
+static bool rx_room(struct regex_compiler *c, size_t cells)
+{
+	if (cells <= c->max - c->n)
+		return true;
+	c->full = true;
+	return rx_fail(c, "it is too long");
+}
+
+static void rx_emit(struct regex_compiler *c, forth_cell_t x)
+{
+	if (rx_room(c, 1))
+		c->code[c->n++] = x;
+}
+
+static bool rx_insert(struct regex_compiler *c, size_t at, size_t cells)
+{
+	if (!rx_room(c, cells))
+		return false;
+	memmove(c->code + at + cells, c->code + at, (c->n - at) * sizeof(*c->code));
+	c->n += cells;
+	return true;
+}
+
+/**
+**rx_optional** makes the fragment of *len* cells at *at* optional,
+**rx_star** lets it be repeated any number of times, including none, and
+**rx_plus** lets it be repeated after it has matched once. The first
+offset of a **RX_SPLIT** is the one preferred, which is swapped over for
+the lazy versions of the repetitions.
+**/
+static bool rx_split(struct regex_compiler *c, size_t at, forth_cell_t x, forth_cell_t y, bool lazy)
+{
+	c->code[at]     = RX_SPLIT;
+	c->code[at + 1] = lazy ? y : x;
+	c->code[at + 2] = lazy ? x : y;
+	return true;
+}
+
+static bool rx_optional(struct regex_compiler *c, size_t at, size_t len, bool lazy)
+{
+	return rx_insert(c, at, 3) && rx_split(c, at, 3, 3 + len, lazy);
+}
+
+static bool rx_star(struct regex_compiler *c, size_t at, size_t len, bool lazy)
+{
+	if (!rx_insert(c, at, 3) || !rx_insert(c, at + 3 + len, 2))
+		return false;
+	c->code[at + 3 + len] = RX_JUMP;
+	c->code[at + 4 + len] = -(forth_cell_t)(3 + len);
+	return rx_split(c, at, 3, 5 + len, lazy);
+}
+
+static bool rx_plus(struct regex_compiler *c, size_t at, size_t len, bool lazy)
+{
+	return rx_insert(c, at + len, 3) && rx_split(c, at + len, -(forth_cell_t)len, 3, lazy);
+}
+
+/**
+**rx_repeat** applies a repetition of between *lo* and *hi* times to the
+fragment that starts at *at*, *hi* is -1 if there is no upper limit. A
+counted repetition is made from copies of the fragment, the first *lo* of
+them are needed and the rest are optional, for example 'e{2,4}' becomes
+'eee?e?' and 'e{2,}' becomes 'ee+'. They are changed from the last
+copy to the first so that inserting instructions does not move a copy
+before it has been changed.
+**/
+static bool rx_repeat(struct regex_compiler *c, size_t at, unsigned long lo, unsigned long hi, bool lazy)
+{
+	const size_t len = c->n - at;
+	const bool unlimited = hi == (unsigned long)-1;
+	const size_t copies = unlimited ? (lo ? lo : 1) : hi;
+	if (!copies) {
+		c->n = at;
+		return true;
+	}
+	if (len && copies - 1 > (c->max - c->n) / len) {
+		c->full = true;
+		return rx_fail(c, "it is too long");
+	}
+	for (size_t i = 1; i < copies; i++, c->n += len)
+		memcpy(c->code + c->n, c->code + at, len * sizeof(*c->code));
+	for (size_t i = copies; i--;) {
+		const size_t copy = at + i * len;
+		if (unlimited && i == copies - 1) {
+			if (!(lo ? rx_plus(c, copy, len, lazy) : rx_star(c, copy, len, lazy)))
+				return false;
+		} else if (i >= lo) {
+			if (!rx_optional(c, copy, len, lazy))
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool rx_count(struct regex_compiler *c, unsigned long *count)
+{
+	if (c->p == c->end || !isdigit((unsigned char)*c->p))
+		return false;
+	for (*count = 0; c->p < c->end && isdigit((unsigned char)*c->p); c->p++)
+		if ((*count = *count * 10 + (*c->p - '0')) > RX_MAX_REPEAT)
+			return rx_fail(c, "a repetition count is too large");
+	return true;
+}
+
+static bool rx_class(struct regex_compiler *c)
+{
+	const size_t at = c->n;
+	bool negate = false;
+	rx_emit(c, RX_CLASS);
+	for (size_t i = 0; i < RX_CLASS_CELLS; i++)
+		rx_emit(c, 0);
+	if (c->error)
+		return false;
+	forth_cell_t *set = c->code + at + 1;
+	if (c->p < c->end && *c->p == '^')
+		negate = true, c->p++;
+	for (bool first = true;; first = false) {
+		int lo, hi;
+		if (c->p == c->end)
+			return rx_fail(c, "a '[' is not closed");
+		if (*c->p == ']' && !first) {
+			c->p++;
+			break;
+		}
+		lo = (unsigned char)*c->p++;
+		if (lo == '\\') {
+			if (c->p == c->end)
+				return rx_fail(c, "it ends with a '\\'");
+			if (rx_escape_class(set, *c->p)) {
+				c->p++;
+				continue;
+			}
+			if ((lo = rx_escape_char(*c->p++)) < 0)
+				return rx_fail(c, "an escape is not recognized");
+		}
+		hi = lo;
+		if (c->end - c->p >= 2 && c->p[0] == '-' && c->p[1] != ']') {
+			c->p++;
+			hi = (unsigned char)*c->p++;
+			if (hi == '\\') {
+				if (c->p == c->end || (hi = rx_escape_char(*c->p++)) < 0)
+					return rx_fail(c, "an escape is not recognized");
+			}
+			if (hi < lo)
+				return rx_fail(c, "a range is backwards");
+		}
+		rx_add_to_class(set, lo, hi);
+	}
+	if (negate)
+		for (size_t i = 0; i < RX_CLASS_CELLS; i++)
+			set[i] = ~set[i];
+	return true;
+}
+
+static bool rx_alternation(struct regex_compiler *c);
+
+static bool rx_atom(struct regex_compiler *c)
+{
+	const char ch = *c->p++;
+	int e;
+	switch (ch) {
+	case '(':
+	{
+		forth_cell_t group = 0;
+		bool capture = !(c->end - c->p >= 2 && c->p[0] == '?' && c->p[1] == ':');
+		if (c->depth >= RX_MAX_DEPTH)
+			return rx_fail(c, "groups are nested too deeply");
+		if (capture) {
+			group = c->groups++;
+			rx_emit(c, RX_SAVE);
+			rx_emit(c, group * 2);
+		} else {
+			c->p += 2;
+		}
+		c->depth++;
+		if (!rx_alternation(c))
+			return false;
+		c->depth--;
+		if (c->p == c->end)
+			return rx_fail(c, "a '(' is not closed");
+		c->p++;
+		if (capture) {
+			rx_emit(c, RX_SAVE);
+			rx_emit(c, group * 2 + 1);
+		}
+		break;
+	}
+	case '*': case '+': case '?': case '{':
+		return rx_fail(c, "there is nothing to repeat");
+	case '[': return rx_class(c);
+	case '.': rx_emit(c, RX_ANY); break;
+	case '^': rx_emit(c, RX_BOL); break;
+	case '$': rx_emit(c, RX_EOL); break;
+	case '\\':
+		if (c->p == c->end)
+			return rx_fail(c, "it ends with a '\\'");
+		if (!rx_room(c, 1 + RX_CLASS_CELLS))
+			return false;
+		memset(c->code + c->n, 0, (1 + RX_CLASS_CELLS) * sizeof(*c->code));
+		if (rx_escape_class(c->code + c->n + 1, *c->p)) {
+			c->code[c->n] = RX_CLASS;
+			c->n += 1 + RX_CLASS_CELLS;
+			c->p++;
+			break;
+		}
+		if ((e = rx_escape_char(*c->p++)) < 0)
+			return rx_fail(c, "an escape is not recognized");
+		rx_emit(c, RX_CHAR);
+		rx_emit(c, e);
+		break;
+	default:
+		rx_emit(c, RX_CHAR);
+		rx_emit(c, (unsigned char)ch);
+	}
+	return !c->error;
+}
+
+static bool rx_term(struct regex_compiler *c)
+{
+	const size_t at = c->n;
+	if (!rx_atom(c))
+		return false;
+	while (c->p < c->end) {
+		unsigned long lo = 0, hi = -1;
+		const char *p = c->p;
+		switch (*c->p++) {
+		case '*': break;
+		case '+': lo = 1; break;
+		case '?': hi = 1; break;
+		case '{':
+			if (!rx_count(c, &lo))
+				return rx_fail(c, "a '{' is not a repetition count");
+			hi = lo;
+			if (c->p < c->end && *c->p == ',') {
+				c->p++;
+				hi = -1;
+				if (c->p < c->end && *c->p != '}' && !rx_count(c, &hi))
+					return rx_fail(c, "a '{' is not a repetition count");
+			}
+			if (c->error || c->p == c->end || *c->p++ != '}')
+				return rx_fail(c, "a '{' is not a repetition count");
+			if (hi < lo)
+				return rx_fail(c, "a repetition count is backwards");
+			break;
+		default:
+			c->p = p;
+			return true;
+		}
+		bool lazy = c->p < c->end && *c->p == '?';
+		c->p += lazy;
+		if (!rx_repeat(c, at, lo, hi, lazy))
+			return false;
+	}
+	return true;
+}
+
+static bool rx_alternation(struct regex_compiler *c)
+{
+	const size_t at = c->n;
+	size_t jump;
+	while (c->p < c->end && *c->p != '|' && *c->p != ')')
+		if (!rx_term(c))
+			return false;
+	if (c->p == c->end || *c->p != '|')
+		return true;
+	c->p++;
+	if (!rx_insert(c, at, 3))
+		return false;
+	jump = c->n;
+	rx_emit(c, RX_JUMP);
+	rx_emit(c, 0);
+	if (c->error)
+		return false;
+	rx_split(c, at, 3, c->n - at, false);
+	if (!rx_alternation(c))
+		return false;
+	c->code[jump + 1] = c->n - jump;
+	return true;
+}
+
+/**
+**regex_compile** compiles a pattern into a program of at most *max* cells
+at *code*, wrapped in the saves of group zero, returning the number of
+cells used, the number of groups is stored in *groups*.
+**/
+static size_t regex_compile(struct regex_compiler *c, const char *pattern, size_t length, forth_cell_t *code, size_t max)
+{
+	memset(c, 0, sizeof(*c));
+	c->start = c->p = pattern;
+	c->end   = pattern + length;
+	c->code  = code;
+	c->max   = max;
+	c->groups = 1;
+	rx_emit(c, RX_SAVE);
+	rx_emit(c, 0);
+	if (!rx_alternation(c))
+		return 0;
+	if (c->p != c->end) {
+		rx_fail(c, "a ')' is not opened");
+		return 0;
+	}
+	rx_emit(c, RX_SAVE);
+	rx_emit(c, 1);
+	rx_emit(c, RX_MATCH);
+	return c->error ? 0 : c->n;
+}
+
+/**
+The machine keeps a list of threads for the current character and a list
+for the next, each thread is a position in the program and its captures,
+which are offsets into the string. A thread is only added to a list once
+for each position in the program, which is what keeps the number of
+threads bounded, *mark* records the generation of the list an instruction
+was last added to. **rx_add** follows jumps, splits, saves and
+assertions with a stack of its own, instead of recursion, as programs can
+be long; a save is undone once everything that followed it has been added.
+**/
+struct rx_list {
+	size_t n;          /**< threads in the list */
+	forth_cell_t *pc;  /**< position of each thread in the program */
+	forth_cell_t *captures; /**< captures of each thread */
+};
+
+struct rx_work {
+	forth_cell_t pc;      /**< instruction to add, or -1 to undo a save */
+	forth_cell_t capture; /**< capture to restore */
+	forth_cell_t value;   /**< value to restore it to */
+};
+
+struct regex_machine {
+	const forth_cell_t *program; /**< program being run */
+	size_t length;     /**< cells in the program */
+	size_t captures;   /**< captures for each thread */
+	size_t *mark;      /**< generation each instruction was added in */
+	size_t generation; /**< generation of the list being added to */
+	struct rx_work *stack; /**< work to do in rx_add */
+	struct rx_list list[2]; /**< threads for this and the next character */
+	forth_cell_t *scratch; /**< captures of a new thread */
+};
+
+static void rx_add(struct regex_machine *vm, struct rx_list *l, forth_cell_t pc, forth_cell_t *captures, size_t sp, size_t end)
+{
+	const forth_cell_t *prog = vm->program;
+	size_t top = 0;
+	vm->stack[top++] = (struct rx_work){ .pc = pc };
+	while (top) {
+		struct rx_work w = vm->stack[--top];
+		if (w.pc == (forth_cell_t)-1) {
+			captures[w.capture] = w.value;
+			continue;
+		}
+		pc = w.pc;
+		if (vm->mark[pc] == vm->generation)
+			continue;
+		vm->mark[pc] = vm->generation;
+		switch (prog[pc]) {
+		case RX_JUMP:
+			vm->stack[top++] = (struct rx_work){ .pc = pc + prog[pc + 1] };
+			break;
+		case RX_SPLIT:
+			vm->stack[top++] = (struct rx_work){ .pc = pc + prog[pc + 2] };
+			vm->stack[top++] = (struct rx_work){ .pc = pc + prog[pc + 1] };
+			break;
+		case RX_SAVE:
+			vm->stack[top++] = (struct rx_work){ -1, prog[pc + 1], captures[prog[pc + 1]] };
+			vm->stack[top++] = (struct rx_work){ .pc = pc + 2 };
+			captures[prog[pc + 1]] = sp;
+			break;
+		case RX_BOL:
+			if (!sp)
+				vm->stack[top++] = (struct rx_work){ .pc = pc + 1 };
+			break;
+		case RX_EOL:
+			if (sp == end)
+				vm->stack[top++] = (struct rx_work){ .pc = pc + 1 };
+			break;
+		default:
+			l->pc[l->n] = pc;
+			memcpy(l->captures + l->n * vm->captures, captures, vm->captures * sizeof(*captures));
+			l->n++;
+		}
+	}
+}
+
+/**
+**regex_run** runs the machine over a string, the match must start at
+the beginning of the string and finish at its end unless *search* is
+true, in which case the leftmost match is found. The captures of the
+match are stored in *match*.
+**/
+static bool regex_run(struct regex_machine *vm, const unsigned char *s, size_t end, bool search, forth_cell_t first, forth_cell_t *match)
+{
+	const forth_cell_t *prog = vm->program;
+	struct rx_list *now = &vm->list[0], *next = &vm->list[1], *t;
+	bool matched = false;
+	now->n = 0;
+	vm->generation++;
+	for (size_t sp = 0;; sp++) {
+		if (!matched && (search || !sp)) {
+			if (!now->n && search && first < 256) {
+				const unsigned char *f = sp < end ? memchr(s + sp, (int)first, end - sp) : NULL;
+				if (!f)
+					break;
+				sp = f - s;
+				vm->generation++;
+			}
+			for (size_t i = 0; i < vm->captures; i++)
+				vm->scratch[i] = -1;
+			rx_add(vm, now, 0, vm->scratch, sp, end);
+		}
+		if (!now->n)
+			break;
+		vm->generation++;
+		next->n = 0;
+		for (size_t i = 0; i < now->n; i++) {
+			const forth_cell_t pc = now->pc[i];
+			forth_cell_t *captures = now->captures + i * vm->captures;
+			switch (prog[pc]) {
+			case RX_CHAR:
+				if (sp < end && s[sp] == prog[pc + 1])
+					rx_add(vm, next, pc + 2, captures, sp + 1, end);
+				break;
+			case RX_ANY:
+				if (sp < end)
+					rx_add(vm, next, pc + 1, captures, sp + 1, end);
+				break;
+			case RX_CLASS:
+				if (sp < end && rx_in_class(prog + pc + 1, s[sp]))
+					rx_add(vm, next, pc + 1 + RX_CLASS_CELLS, captures, sp + 1, end);
+				break;
+			case RX_MATCH:
+				if (!search && sp != end)
+					break;
+				memcpy(match, captures, vm->captures * sizeof(*captures));
+				matched = true;
+				now->n = i + 1; /* threads after this one are less preferred */
+				break;
+			}
+		}
+		t = now, now = next, next = t;
+		if (sp >= end)
+			break;
+	}
+	return matched;
+}
+
+/**
+**regex_check** makes sure a program can be run safely, that every
+instruction is whole, every jump lands on an instruction, and every save
+is to a capture that exists. Only a **RX_MATCH** may end the program.
+**/
+static bool regex_check(const forth_cell_t *prog, size_t length, size_t captures, size_t *mark)
+{
+	forth_cell_t pc, x, y;
+	memset(mark, 0, length * sizeof(*mark));
+	for (pc = 0; pc < length; pc += rx_length(prog[pc])) {
+		if (prog[pc] >= LAST_RX_INSTRUCTION || rx_length(prog[pc]) > length - pc)
+			return false;
+		mark[pc] = 1;
+	}
+	for (pc = 0; pc < length; pc += rx_length(prog[pc])) {
+		const forth_cell_t next = pc + rx_length(prog[pc]);
+		switch (prog[pc]) {
+		case RX_SPLIT:
+			y = pc + prog[pc + 2];
+			if (y >= length || !mark[y])
+				return false;
+			/* fall through */
+		case RX_JUMP:
+			x = pc + prog[pc + 1];
+			if (x >= length || !mark[x])
+				return false;
+			break;
+		case RX_SAVE:
+			if (prog[pc + 1] >= captures)
+				return false;
+			/* fall through */
+		default:
+			if (prog[pc] != RX_MATCH && next >= length)
+				return false;
+		}
+	}
+	memset(mark, 0, length * sizeof(*mark));
+	return true;
+}
+
+/**
+## Hash Maps
+
+A hash map is a block of cells in the core, so it is saved along with
+the rest of the core, laid out as a header followed by a power of two
+number of slots:
+
+	.----------.-------.------.--------.--------.-----.
+	| capacity | count | used | slot 0 | slot 1 | ... |
+	.----------.-------.------.--------.--------.-----.
+
+Where *count* is the number of keys stored and *used* also counts the
+slots left behind by deleted keys. Each slot is four cells long:
+
+	.------.-----.--------.-------.
+	| hash | key | length | value |
+	.------.-----.--------.-------.
+
+A key is either a cell, in which case its length is **MAP_CELL_KEY**, or
+a string, which is stored as the address and length of the string so it
+must not be moved or changed whilst it is in the map. A hash of zero 
+marks an empty slot and a hash of one a deleted one, so hashes are moved
+out of the way of those values.
+
+Collisions are resolved with linear probing, and a map counts as full
+when three quarters of its slots have been used, as beyond that the
+number of slots that have to be looked at grows quickly. The maps cannot
+grow as they do not own the memory after them, but the slots held by
+deleted keys are won back by rehashing the map in place when it fills
+up or when its last key is removed.
+**/
+#define MAP_CELL_KEY ((forth_cell_t)-1)
+#define MAP_EMPTY    (0)
+#define MAP_DELETED  (1)
+
+enum map_header { MAP_CAPACITY, MAP_COUNT, MAP_USED, MAP_HEADER_SIZE };
+enum map_slot { SLOT_HASH, SLOT_KEY, SLOT_LENGTH, SLOT_VALUE, MAP_SLOT_SIZE };
+
+/**
+Strings are hashed with FNV-1a, cells by multiplying them by a constant
+derived from the golden ratio and mixing the top half of the result back
+into the bottom half, which the slot index is taken from.
+**/
+static forth_cell_t forth_map_hash(const char *core, forth_cell_t key, forth_cell_t len)
+{
+	forth_cell_t h;
+	if (len == MAP_CELL_KEY) {
+		h = key * (forth_cell_t)0x9E3779B97F4A7C15ull;
+		h ^= h >> (sizeof(h) * CHAR_BIT / 2);
+	} else {
+#if UINTPTR_MAX == UINT64_MAX
+		h = 14695981039346656037ull;
+		for (forth_cell_t i = 0; i < len; i++)
+			h = (h ^ (unsigned char)core[key + i]) * 1099511628211ull;
+#else
+		h = 2166136261ul;
+		for (forth_cell_t i = 0; i < len; i++)
+			h = (h ^ (unsigned char)core[key + i]) * 16777619ul;
+#endif
+	}
+	return h <= MAP_DELETED ? h + MAP_DELETED + 1 : h;
+}
+
+/**
+**forth_map_probe** returns the slot a key is in, or NULL if it is not
+in the map, in which case *space* is set to the first slot it could be
+put in, or NULL if there is none.
+**/
+static forth_cell_t *forth_map_probe(const char *core, forth_cell_t *map, 
+		forth_cell_t key, forth_cell_t len, forth_cell_t h, forth_cell_t **space)
+{
+	const forth_cell_t mask = map[MAP_CAPACITY] - 1;
+	*space = NULL;
+	for (forth_cell_t i = h & mask, n = 0; n <= mask; i = (i + 1) & mask, n++) {
+		forth_cell_t *s = map + MAP_HEADER_SIZE + i * MAP_SLOT_SIZE;
+		if (s[SLOT_HASH] == MAP_EMPTY) {
+			if (!*space)
+				*space = s;
+			return NULL;
+		}
+		if (s[SLOT_HASH] == MAP_DELETED) {
+			if (!*space)
+				*space = s;
+			continue;
+		}
+		if (s[SLOT_HASH] != h || s[SLOT_LENGTH] != len)
+			continue;
+		if (len == MAP_CELL_KEY ? s[SLOT_KEY] == key : 
+				!memcmp(core + s[SLOT_KEY], core + key, len))
+			return s;
+	}
+	return NULL;
+}
+
+static forth_cell_t *forth_map_find(const char *core, forth_cell_t *map, 
+		forth_cell_t key, forth_cell_t len)
+{
+	forth_cell_t *space;
+	return forth_map_probe(core, map, key, len, forth_map_hash(core, key, len), &space);
+}
+
+/**
+**forth_map_rehash** empties the deleted slots and then moves each key
+back to the first empty slot from where it hashes to. Moving one key can
+open up a gap in front of a key that has already been looked at, so the
+passes are repeated until nothing moves, which must happen as every move
+brings a key closer to its home slot. This is slow but rare, and needs
+no memory other than the map itself.
+**/
+static void forth_map_rehash(forth_cell_t *map)
+{
+	const forth_cell_t mask = map[MAP_CAPACITY] - 1;
+	forth_cell_t *slots = map + MAP_HEADER_SIZE;
+	bool moved;
+	for (forth_cell_t i = 0; i <= mask; i++)
+		if (slots[i * MAP_SLOT_SIZE + SLOT_HASH] == MAP_DELETED)
+			slots[i * MAP_SLOT_SIZE + SLOT_HASH] = MAP_EMPTY;
+	map[MAP_USED] = map[MAP_COUNT];
+	do {
+		moved = false;
+		for (forth_cell_t i = 0; i <= mask; i++) {
+			forth_cell_t *s = slots + i * MAP_SLOT_SIZE, *d, j;
+			const forth_cell_t h = s[SLOT_HASH];
+			if (h == MAP_EMPTY)
+				continue;
+			s[SLOT_HASH] = MAP_EMPTY;
+			for (j = h & mask; slots[j * MAP_SLOT_SIZE + SLOT_HASH] != MAP_EMPTY; j = (j + 1) & mask)
+				;
+			d = slots + j * MAP_SLOT_SIZE;
+			if (d != s) {
+				memcpy(d, s, MAP_SLOT_SIZE * sizeof(*s));
+				moved = true;
+			}
+			d[SLOT_HASH] = h;
+		}
+	} while (moved);
+}
+
+static bool forth_map_store(const char *core, forth_cell_t *map, 
+		forth_cell_t key, forth_cell_t len, forth_cell_t value)
+{
+	forth_cell_t h = forth_map_hash(core, key, len), *space;
+	forth_cell_t *s = forth_map_probe(core, map, key, len, h, &space);
+	if (!s) {
+		if (!space)
+			return false;
+		if (space[SLOT_HASH] == MAP_EMPTY) {
+			if ((map[MAP_USED] + 1) * 4 > map[MAP_CAPACITY] * 3) {
+				if (map[MAP_USED] == map[MAP_COUNT])
+					return false;
+				forth_map_rehash(map);
+				(void)forth_map_probe(core, map, key, len, h, &space);
+			}
+			map[MAP_USED]++;
+		}
+		map[MAP_COUNT]++;
+		s = space;
+		s[SLOT_HASH]   = h;
+		s[SLOT_KEY]    = key;
+		s[SLOT_LENGTH] = len;
+	}
+	s[SLOT_VALUE] = value;
+	return true;
+}
+
+static bool forth_map_delete(const char *core, forth_cell_t *map, 
+		forth_cell_t key, forth_cell_t len)
+{
+	forth_cell_t *s = forth_map_find(core, map, key, len);
+	if (!s)
+		return false;
+	s[SLOT_HASH] = MAP_DELETED;
+	if (!--map[MAP_COUNT])
+		forth_map_rehash(map);
+	return true;
+}
+
+/**
+**forth_map_next** is used to iterate over a map, it returns one more
+than the index of the first slot at or after slot *i* that holds a key,
+or zero if there are no more.
+**/
+static forth_cell_t forth_map_next(const forth_cell_t *map, forth_cell_t i)
+{
+	for (; i < map[MAP_CAPACITY]; i++)
+		if (map[MAP_HEADER_SIZE + i * MAP_SLOT_SIZE + SLOT_HASH] > MAP_DELETED)
+			return i + 1;
+	return 0;
+}
+
+/** 
+@brief Forths are usually case insensitive and are required to be (or
+at least accept only uppercase characters only) by the majority of the
+standards for Forth.  As an aside I do not believe case insensitivity is
+a good idea as it complicates interfaces and creates as much confusion
+as it tries to solve (not only that, but different case letters do convey
+information). However, in keeping with other implementations, this Forth
+is also made insensitive to case **DUP** is treated the same as **dup**
+and **Dup**.
+
+This comparison function, **istrcmp**, is only used in one place however,
+in the C function **forth_find**, replacing it with **strcmp** will
+bring back the more logical, case sensitive, behavior.
+
+@param  a   first string to compare
+@param  b   second string
+@return int same as **strcmp**, only case insensitive
+
+**/
+static int istrcmp(const char *a, const char *b)
+{
+	for (; ((*a == *b) || (tolower(*a) == tolower(*b))) && *a && *b; a++, b++)
+		;
+	return tolower(*a) - tolower(*b);
+}
+
+/**
+The **match** function returns true if the word is not hidden and if
+a case insensitive comparison of its name has succeeded. The key of the
+name being looked for, made by **forth_name_key**, is compared to the one
+stored in the header first, so nearly every word that does not match is
+rejected without looking at its name.
+**/
+static int match(forth_cell_t *m, forth_cell_t pwd, const char *s, forth_cell_t key)
+{
+	forth_cell_t len = WORD_LENGTH(m[pwd + 1]);
+	return m[pwd - len - 1] == key && !WORD_HIDDEN(m[pwd+1]) 
+		&& !istrcmp(s, (char*)(&m[pwd-len]));
+}
+
+/**
+**forth_find_wordlist** searches the thread of a single wordlist that the
+name **s** hashes to, it returns the **PWD** field of the word or zero,
+**key** is the key of **s**. The thread link is found before the name of 
+each word, and as words are
+only ever linked to earlier words a link that does not go backwards ends 
+the search, so a bad wordlist cannot lead us astray.
+**/
+static forth_cell_t forth_find_wordlist(forth_t *o, forth_cell_t wid, 
+		const char *s, forth_cell_t key)
+{
+	forth_cell_t *m = o->m, last = m[DIC];
+	forth_cell_t pwd = m[wid + WORDLIST_HEADS + KEY_THREAD(key)];
+	for (;pwd > DICTIONARY_START && pwd < last && !match(m, pwd, s, key);) {
+		last = pwd;
+		pwd = m[WORD_THREAD(m, pwd)];
+	}
+	return pwd > DICTIONARY_START && pwd < last ? pwd : 0;
+}
+
+/** 
+**forth_find** finds a word in the dictionary and if it exists it returns a
+pointer to its **PWD** field. If it is not found it will return zero, also of
+notes is the fact that it will skip words that are hidden, that is the
+hidden bit in the **CODE** field of a word is set. The structure of the
+dictionary has already been explained, so there should be no surprises in
+this word, only the wordlists in the search order are searched, the first
+in the order first, and within them only one thread. Any improvements to 
+the speed of this word would speed up the text interpreter a lot, but not 
+the virtual machine in general.
+**/
+forth_cell_t forth_find(forth_t *o, const char *s)
+{
+	forth_cell_t *m = o->m, pwd = 0, key = forth_name_key(s);
+	for (forth_cell_t i = 0; i < m[ORDER] && i < MAXIMUM_ORDER && !pwd; i++)
+		pwd = forth_find_wordlist(o, m[CONTEXT + i], s, key);
+	return pwd ? pwd + 1 : 0;
+}
+
+/**
+**forth_in_order** is true if the word with the **PWD** field **pwd** can
+be reached from the search order, it does not matter if it is hidden or
+redefined by a later word.
+**/
+static int forth_in_order(forth_t *o, forth_cell_t pwd)
+{
+	forth_cell_t *m = o->m, thread = KEY_THREAD(m[WORD_KEY(m, pwd)]);
+	for (forth_cell_t i = 0; i < m[ORDER] && i < MAXIMUM_ORDER; i++) {
+		forth_cell_t w = m[m[CONTEXT + i] + WORDLIST_HEADS + thread];
+		for (;w > pwd; w = m[WORD_THREAD(m, w)])
+			;
+		if (w == pwd)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+@brief Print a number in a given base to an output stream
+@param o    initialized forth environment
+@param out  output file stream
+@param u    number to print
+@return number of characters written, or negative on failure 
+**/
+static int print_cell(forth_t *o, FILE *out, forth_cell_t u)
+{
+	int i = 0, r = 0;
+	char s[64 + 1] = {0}; 
+	unsigned base = o->m[BASE];
+	base = base != 0 ? base : 10 ;
+	if (base >= 37)
+		return -1;
+	if (base == 10)
+		return fprintf(out, "%"PRIdCell, u);
+	do 
+		s[i++] = conv[u % base];
+	while ((u /= base));
+	for (r = --i; i >= 0; i--)
+		if (fputc(s[i], out) != s[i])
+			return -1;
+	return r;
+}
+
+/**
+**check_bounds** is used to both check that a memory access performed by
+the virtual machine is within range and as a crude method of debugging the
+interpreter (if it is enabled). The function is not called directly but is
+instead wrapped in with the **ck** macro, it can be removed with
+compile time defines, removing the check and the debugging code.
+
+None of the checks jump out of the virtual machine when they fail, they
+record the failure in **o->fault** and return a value that is safe to use
+instead, the virtual machine then acts on the fault before executing the
+next instruction. A failed bounds check invalidates the core as well.
+**/
+static forth_cell_t check_bounds(forth_t *o, forth_cell_t f, 
+		unsigned line, forth_cell_t bound)
+{
+	if (o->m[DEBUG] >= FORTH_DEBUG_CHECKS)
+		debug("0x%"PRIxCell " %u", f, line);
+	if (f >= bound) {
+		fatal("bounds check failed (%"PRIdCell" >= %zu) C line %u Forth Line %zu", 
+				f, (size_t)bound, line, o->line);
+		forth_invalidate(o);
+		o->fault = THROW_INVALID_ADDRESS;
+		return 0;
+	}
+	return f;
+}
+
+/**
+**check_depth** is used to check that there are enough values on the stack
+before an operation takes place. It is wrapped up in the **cd** macro. 
+**/
+static void check_depth(forth_t *o, forth_cell_t *S, 
+		forth_cell_t expected, unsigned line)
+{
+	if (o->m[DEBUG] >= FORTH_DEBUG_CHECKS)
+		debug("0x%"PRIxCell " %u", (forth_cell_t)(S - o->vstart), line);
+	if ((uintptr_t)(S - o->vstart) < expected) {
+		error("stack underflow %p -> %u (line %zu)", S - o->vstart, line, o->line);
+		o->fault = THROW_STACK_UNDERFLOW;
+	} else if (S > o->vend) {
+		error("stack overflow %p -> %u (line %zu)", S - o->vend, line, o->line);
+		o->fault = THROW_STACK_OVERFLOW;
+	}
+}
+
+/**
+Check that the dictionary pointer does not go into the stack area:
+**/
+static forth_cell_t check_dictionary(forth_t *o, forth_cell_t dptr)
+{
+	if ((o->m + dptr) >= (o->vstart)) {
+		fatal("dictionary pointer is in stack area %"PRIdCell, dptr);
+		forth_invalidate(o);
+		o->fault = THROW_DICTIONARY_OVERFLOW;
+		return 0;
+	}
+	return dptr;
+}
+
+/**
+**check_range** checks that **n** items starting at **addr** fit within
+**size** items, without the end of the range overflowing as **addr + n**
+can for large arguments. It throws an invalid address if not, but it does
+not invalidate the core, as nothing has been written out of bounds.
+**/
+static int check_range(forth_t *o, forth_cell_t addr, forth_cell_t n, 
+		forth_cell_t size)
+{
+	if (addr <= size && n <= size - addr)
+		return 0;
+	error("invalid range %"PRIdCell" of length %"PRIdCell, addr, n);
+	o->fault = THROW_INVALID_ADDRESS;
+	return -1;
+}
+
+/**
+**check_map** checks that a hash map has a capacity that is a power of two
+and that it fits within the core, returning a pointer to it.
+**/
+static forth_cell_t *check_map(forth_t *o, forth_cell_t map)
+{
+	forth_cell_t capacity;
+	if (map >= o->core_size - MAP_HEADER_SIZE)
+		goto fail;
+	capacity = o->m[map + MAP_CAPACITY];
+	if (!capacity || (capacity & (capacity - 1)) || 
+		capacity > (o->core_size - map - MAP_HEADER_SIZE) / MAP_SLOT_SIZE)
+		goto fail;
+	return o->m + map;
+fail:
+	error("invalid hash map at %"PRIdCell, map);
+	o->fault = THROW_INVALID_ARGUMENT;
+	return NULL;
+}
+
+/**
+**check_big** checks that a bignum fits within the core and that it is
+using no more limbs than it has room for, returning a pointer to it.
+**/
+static forth_cell_t *check_big(forth_t *o, forth_cell_t big)
+{
+	forth_cell_t *b;
+	if (big >= o->core_size - BIG_LIMBS)
+		goto fail;
+	b = o->m + big;
+	if (b[BIG_CAPACITY] > o->core_size - big - BIG_LIMBS 
+		|| (b[BIG_SIZE] & ~SIGN_BIT) > b[BIG_CAPACITY])
+		goto fail;
+	return b;
+fail:
+	error("invalid bignum at %"PRIdCell, big);
+	o->fault = THROW_INVALID_ARGUMENT;
+	return NULL;
+}
+
+#define BIG_LENGTH(B)   ((size_t)((B)[BIG_SIZE] & ~SIGN_BIT))
+#define BIG_NEGATIVE(B) (!!((B)[BIG_SIZE] & SIGN_BIT))
+
+/**
+**big_store** stores a result of *n* limbs at *x* into the bignum *d*,
+it returns zero or the error to throw if it does not fit.
+**/
+static int big_store(forth_cell_t *d, const forth_cell_t *x, size_t n, bool negative)
+{
+	n = big_trim(x, n);
+	if (n > d[BIG_CAPACITY])
+		return THROW_RESULT_OUT_OF_RANGE;
+	memmove(d + BIG_LIMBS, x, n * sizeof(*x));
+	d[BIG_SIZE] = n | (n && negative ? SIGN_BIT : 0);
+	return 0;
+}
+
+static unsigned big_base(forth_t *o)
+{
+	forth_cell_t base = o->m[BASE];
+	return base ? (base >= 2 && base <= 36 ? base : 0) : 10;
+}
+
+/**
+**forth_bignum** performs one of the **bignum_operations** for the 
+**(bignum)** instruction, *args* holds the cells it takes off the stack,
+deepest first, and a result is stored in *result*. It returns zero or
+the error to throw.
+**/
+static int forth_bignum(forth_t *o, forth_cell_t op, const forth_cell_t *args, forth_cell_t *result)
+{
+	forth_cell_t *a = NULL, *b = NULL, *d = NULL, *t = NULL, *r, v;
+	const forth_cell_t *x, *y;
+	size_t an = 0, bn = 0, n;
+	bool negative;
+	int rval = 0;
+	switch (op) {
+	case BIG_STORE: 
+		if (!(d = check_big(o, args[1])))
+			return o->fault;
+		negative = args[0] & SIGN_BIT;
+		v = negative ? -args[0] : args[0];
+		return big_store(d, &v, 1, negative);
+	case BIG_TO_CELL:
+		if (!(a = check_big(o, args[0])))
+			return o->fault;
+		v = BIG_LENGTH(a) ? a[BIG_LIMBS] : 0;
+		*result = BIG_NEGATIVE(a) ? -v : v;
+		return 0;
+	case BIG_COPY:
+		if (!(a = check_big(o, args[0])) || !(d = check_big(o, args[1])))
+			return o->fault;
+		return big_store(d, a + BIG_LIMBS, BIG_LENGTH(a), BIG_NEGATIVE(a));
+	case BIG_PRINT:
+	{
+		char *s;
+		unsigned base = big_base(o);
+		if (!(a = check_big(o, args[0])))
+			return o->fault;
+		if (!base)
+			return THROW_INVALID_ARGUMENT;
+		n = BIG_LENGTH(a) * CELL_BITS + 1;
+		if (!(s = malloc(n)))
+			return THROW_ALLOCATE;
+		n = big_to_string(s, n, a + BIG_LIMBS, BIG_LENGTH(a), base);
+		fprintf((FILE*)(o->m[FOUT]), "%s%.*s ", BIG_NEGATIVE(a) ? "-" : "", (int)n, s);
+		free(s);
+		return 0;
+	}
+	case BIG_TO_STRING:
+	{
+		char *s = (char*)o->m + args[1];
+		size_t max = args[2];
+		unsigned base = big_base(o);
+		if (!(a = check_big(o, args[0])))
+			return o->fault;
+		if (!base)
+			return THROW_INVALID_ARGUMENT;
+		if (args[2])
+			(void)ckchar(args[1] + args[2] - 1);
+		if (o->fault)
+			return o->fault;
+		if ((negative = BIG_NEGATIVE(a))) {
+			if (!max)
+				return THROW_RESULT_OUT_OF_RANGE;
+			*s++ = '-';
+			max--;
+		}
+		n = big_to_string(s, max, a + BIG_LIMBS, BIG_LENGTH(a), base);
+		if (n > max)
+			return THROW_RESULT_OUT_OF_RANGE;
+		*result = n + negative;
+		return 0;
+	}
+	case STRING_TO_BIG:
+	{
+		const char *s = (char*)o->m + args[0];
+		long used;
+		unsigned base = big_base(o);
+		if (!(d = check_big(o, args[2])))
+			return o->fault;
+		if (!base)
+			return THROW_INVALID_ARGUMENT;
+		if (args[1])
+			(void)ckchar(args[0] + args[1] - 1);
+		if (o->fault)
+			return o->fault;
+		n = args[1];
+		negative = n && *s == '-';
+		if (n && (*s == '-' || *s == '+'))
+			s++, n--;
+		if (!(t = malloc((d[BIG_CAPACITY] + 1) * sizeof(*t))))
+			return THROW_ALLOCATE;
+		used = big_from_string(t, d[BIG_CAPACITY], s, n, base);
+		*result = used >= 0;
+		if (used == -2)
+			rval = THROW_RESULT_OUT_OF_RANGE;
+		else if (used >= 0)
+			rval = big_store(d, t, used, negative);
+		free(t);
+		return rval;
+	}
+	}
+
+	if (!(a = check_big(o, args[0])) || !(b = check_big(o, args[1])))
+		return o->fault;
+	an = BIG_LENGTH(a), bn = BIG_LENGTH(b);
+	x = a + BIG_LIMBS, y = b + BIG_LIMBS;
+	switch (op) {
+	case BIG_COMPARE:
+	{
+		int sa = BIG_NEGATIVE(a), sb = BIG_NEGATIVE(b), c;
+		if (sa != sb)
+			c = sa ? -1 : 1;
+		else
+			c = sa ? -big_compare_magnitude(x, an, y, bn) : big_compare_magnitude(x, an, y, bn);
+		*result = (forth_cell_t)(intptr_t)c;
+		return 0;
+	}
+	case BIG_ADD:
+	case BIG_SUB:
+	{
+		bool sa = BIG_NEGATIVE(a), sb = BIG_NEGATIVE(b) ^ (op == BIG_SUB);
+		if (!(d = check_big(o, args[2])))
+			return o->fault;
+		if (big_compare_magnitude(x, an, y, bn) < 0) {
+			const forth_cell_t *z = x;
+			size_t zn = an;
+			bool sz = sa;
+			x = y, an = bn, sa = sb;
+			y = z, bn = zn, sb = sz;
+		}
+		if (!(t = malloc((an + 1) * sizeof(*t))))
+			return THROW_ALLOCATE;
+		memcpy(t, x, an * sizeof(*t));
+		t[an] = 0;
+		if (sa == sb)
+			big_add_into(t, an + 1, y, bn);
+		else
+			big_sub_into(t, an + 1, y, bn);
+		rval = big_store(d, t, an + 1, sa);
+		break;
+	}
+	case BIG_MUL:
+		if (!(d = check_big(o, args[2])))
+			return o->fault;
+		if (!an || !bn)
+			return big_store(d, x, 0, false);
+		if (!(t = malloc((an + bn) * sizeof(*t))))
+			return THROW_ALLOCATE;
+		big_mul(t, x, an, y, bn);
+		rval = big_store(d, t, an + bn, BIG_NEGATIVE(a) != BIG_NEGATIVE(b));
+		break;
+	case BIG_DIVMOD:
+		if ((args[2] && !check_big(o, args[2])) || (args[3] && !check_big(o, args[3])))
+			return o->fault;
+		if (!bn)
+			return THROW_DIVISION_BY_ZERO;
+		n = an >= bn ? an - bn + 1 : 0;
+		if (!(t = malloc((n + an + 1) * sizeof(*t))))
+			return THROW_ALLOCATE;
+		if (an < bn)
+			memcpy(t, x, an * sizeof(*t));
+		else if (big_divide(t + an, t, x, an, y, bn))
+			rval = THROW_ALLOCATE;
+		if (!rval && args[2])
+			rval = big_store(o->m + args[2], t + an, n, BIG_NEGATIVE(a) != BIG_NEGATIVE(b));
+		if (!rval && args[3])
+			rval = big_store(o->m + args[3], t, an < bn ? an : bn, BIG_NEGATIVE(a));
+		break;
+	case BIG_POWMOD:
+	{
+		forth_cell_t *c, *acc, *base;
+		size_t cn, accn = 1, basen;
+		if (!(c = check_big(o, args[2])) || !(d = check_big(o, args[3])))
+			return o->fault;
+		cn = BIG_LENGTH(c);
+		if (!cn || BIG_NEGATIVE(c) || BIG_NEGATIVE(b))
+			return THROW_INVALID_ARGUMENT;
+		n = (an > 2 * cn ? an : 2 * cn) + 1;
+		if (!(t = calloc(3 * n, sizeof(*t))))
+			return THROW_ALLOCATE;
+		base = t, acc = t + n, r = t + 2 * n;
+		memcpy(base, x, an * sizeof(*t));
+		acc[0] = 1;
+		if (!(basen = big_reduce(base, an, c + BIG_LIMBS, cn)) 
+			|| !(accn = big_reduce(acc, 1, c + BIG_LIMBS, cn))) {
+			rval = THROW_ALLOCATE;
+			break;
+		}
+		if (BIG_NEGATIVE(a) && big_trim(base, basen)) { /* (-x) mod c = c - x */
+			memcpy(r, c + BIG_LIMBS, cn * sizeof(*t));
+			big_sub_into(r, cn, base, basen);
+			memcpy(base, r, cn * sizeof(*t));
+			basen = cn;
+		}
+		for (size_t i = 0; i < bn && !rval; i++) {
+			for (unsigned j = 0; j < CELL_BITS && !rval; j++) {
+				if ((y[i] >> j) & 1) {
+					big_mul(r, acc, accn, base, basen);
+					forth_cell_t *s = acc; acc = r; r = s;
+					if (!(accn = big_reduce(acc, accn + basen, c + BIG_LIMBS, cn)))
+						rval = THROW_ALLOCATE;
+				}
+				if (i == bn - 1 && !(y[i] >> j >> 1))
+					break;
+				big_mul(r, base, basen, base, basen);
+				forth_cell_t *s = base; base = r; r = s;
+				if (!(basen = big_reduce(base, 2 * basen, c + BIG_LIMBS, cn)))
+					rval = THROW_ALLOCATE;
+			}
+		}
+		if (!rval)
+			rval = big_store(d, acc, accn, false);
+		break;
+	}
+	default:
+		rval = THROW_INVALID_ARGUMENT;
+	}
+	free(t);
+	return rval;
+}
+
+/**
+**check_regex** checks that a compiled regular expression fits within the
+core and that it has room for its captures and a program, returning a
+pointer to it. The program itself is checked by **regex_check**.
+**/
+static forth_cell_t *check_regex(forth_t *o, forth_cell_t regex)
+{
+	forth_cell_t *r;
+	if (regex >= o->core_size - REGEX_CAPTURES)
+		goto fail;
+	r = o->m + regex;
+	if (r[REGEX_SIZE] > o->core_size - regex || r[REGEX_SIZE] <= REGEX_CAPTURES
+		|| !r[REGEX_GROUPS] || r[REGEX_GROUPS] >= (r[REGEX_SIZE] - REGEX_CAPTURES) / 2)
+		goto fail;
+	return r;
+fail:
+	error("invalid regular expression at %"PRIdCell, regex);
+	o->fault = THROW_INVALID_ARGUMENT;
+	return NULL;
+}
+
+/**
+**forth_regex** performs one of the **regex_operations** for the
+**(regex)** instruction, *args* holds the cells it takes off the stack,
+deepest first, and its results are stored in *results*. It returns zero
+or the error to throw. A pattern is compiled into memory from **malloc**
+before it is copied into the core, so the pattern may be held in the
+space the regular expression is being compiled into.
+**/
+static int forth_regex(forth_t *o, forth_cell_t op, const forth_cell_t *args, forth_cell_t *results)
+{
+	struct regex_machine vm = { .program = NULL };
+	forth_cell_t *r, *match = NULL, groups;
+	int rval = 0;
+	switch (op) {
+	case REGEX_COMPILE:
+	{
+		struct regex_compiler c;
+		forth_cell_t *code;
+		size_t n, max;
+		if (args[1])
+			(void)ckchar(args[0] + args[1] - 1);
+		if (o->fault)
+			return o->fault;
+		if (args[2] > o->core_size || args[3] > o->core_size - args[2])
+			return THROW_INVALID_ADDRESS;
+		if (args[3] <= REGEX_CAPTURES + 2)
+			return THROW_RESULT_OUT_OF_RANGE;
+		max = args[3] - REGEX_CAPTURES;
+		if (!(code = malloc(max * sizeof(*code))))
+			return THROW_ALLOCATE;
+		n = regex_compile(&c, (char*)o->m + args[0], args[1], code, max);
+		if (n && c.groups * 2 > max - n)
+			n = 0, c.full = true;
+		if (!n) {
+			free(code);
+			if (c.full)
+				return THROW_RESULT_OUT_OF_RANGE;
+			error("invalid regular expression, %s, at character %zu", 
+					c.error, (size_t)(c.p - c.start));
+			return THROW_INVALID_ARGUMENT;
+		}
+		r = o->m + args[2];
+		r[REGEX_SIZE]   = REGEX_CAPTURES + c.groups * 2 + n;
+		r[REGEX_GROUPS] = c.groups;
+		r[REGEX_FIRST]  = code[2] == RX_CHAR ? code[3] : (forth_cell_t)-1;
+		for (forth_cell_t i = 0; i < c.groups * 2; i++)
+			r[REGEX_CAPTURES + i] = -1;
+		memcpy(r + REGEX_CAPTURES + c.groups * 2, code, n * sizeof(*code));
+		results[0] = r[REGEX_SIZE];
+		free(code);
+		return 0;
+	}
+	case REGEX_GROUP:
+	{
+		forth_cell_t begin, end;
+		if (!(r = check_regex(o, args[1])))
+			return o->fault;
+		results[0] = results[1] = 0;
+		if (args[0] >= r[REGEX_GROUPS])
+			return 0;
+		begin = r[REGEX_CAPTURES + args[0] * 2];
+		end   = r[REGEX_CAPTURES + args[0] * 2 + 1];
+		if (begin != (forth_cell_t)-1 && end != (forth_cell_t)-1 && end >= begin) {
+			results[0] = begin;
+			results[1] = end - begin;
+		}
+		return 0;
+	}
+	case REGEX_MATCH:
+	case REGEX_SEARCH:
+		break;
+	default:
+		return THROW_INVALID_ARGUMENT;
+	}
+
+	if (!(r = check_regex(o, args[2])))
+		return o->fault;
+	if (args[1])
+		(void)ckchar(args[0] + args[1] - 1);
+	if (o->fault)
+		return o->fault;
+	groups      = r[REGEX_GROUPS];
+	vm.captures = groups * 2;
+	vm.program  = r + REGEX_CAPTURES + vm.captures;
+	vm.length   = r[REGEX_SIZE] - REGEX_CAPTURES - vm.captures;
+	vm.mark     = malloc(vm.length * sizeof(*vm.mark));
+	vm.stack    = malloc((vm.length * 2 + 1) * sizeof(*vm.stack));
+	vm.scratch  = malloc(vm.captures * sizeof(*vm.scratch));
+	match       = malloc(vm.captures * sizeof(*match));
+	for (size_t i = 0; i < 2; i++) {
+		vm.list[i].pc       = malloc(vm.length * sizeof(*vm.list[i].pc));
+		vm.list[i].captures = malloc(vm.length * vm.captures * sizeof(*vm.list[i].captures));
+		if (!vm.list[i].pc || !vm.list[i].captures)
+			rval = THROW_ALLOCATE;
+	}
+	if (rval || !vm.mark || !vm.stack || !vm.scratch || !match) {
+		rval = THROW_ALLOCATE;
+		goto done;
+	}
+	if (!regex_check(vm.program, vm.length, vm.captures, vm.mark)) {
+		error("invalid regular expression program at %"PRIdCell, args[2]);
+		rval = THROW_INVALID_ARGUMENT;
+		goto done;
+	}
+	bool matched = regex_run(&vm, (unsigned char*)o->m + args[0], args[1], 
+			op == REGEX_SEARCH, r[REGEX_FIRST], match);
+	if (matched)
+		for (size_t i = 0; i < vm.captures; i++)
+			r[REGEX_CAPTURES + i] = match[i] == (forth_cell_t)-1 ? match[i] : args[0] + match[i];
+	if (op == REGEX_MATCH) {
+		results[0] = matched;
+	} else {
+		results[0] = matched ? r[REGEX_CAPTURES] : args[0];
+		results[1] = matched ? r[REGEX_CAPTURES + 1] - r[REGEX_CAPTURES] : args[1];
+		results[2] = matched;
+	}
+done:
+	for (size_t i = 0; i < 2; i++) {
+		free(vm.list[i].pc);
+		free(vm.list[i].captures);
+	}
+	free(vm.mark);
+	free(vm.stack);
+	free(vm.scratch);
+	free(match);
+	return rval;
+}
+
+/**
+This checks that a Forth string is *NUL* terminated, as required by most C
+functions, which should be the last character in string (which is s+end).
+There is a bit of a mismatch between Forth strings (which are pointer to
+the string and a length) and C strings, which a pointer to the string and
+are *NUL* terminated. This function helps to correct that.
+**/
+static int check_is_asciiz(forth_t *o, char *s, forth_cell_t end)
+{
+	if (*(s + end) != '\0') {
+		error("not an ASCIIZ string at %p", s);
+		o->fault = THROW_INVALID_ARGUMENT;
+		return -1;
+	}
+	return 0;
+}
+
+/**
+This function gets a string off the Forth stack, checking that the string
+is *NUL* terminated. It is a helper function used when a Forth string has to
+be converted to a C string so it can be passed to a C function. It returns
+NULL if the check fails.
+**/
+static char *forth_get_string(forth_t *o, forth_cell_t **S, forth_cell_t f)
+{
+	forth_cell_t length = f + 1;
+	char *string = ((char*)o->m) + **S;
+	(*S)--;
+	return check_is_asciiz(o, string, length) < 0 ? NULL : string;
+}
+
+/** 
+Forth file access methods (or *fam*s) must be held in a single cell, this
+requires a method of translation from this cell into a string that can be
+used by the C function **fopen**, NULL is returned for an invalid *fam*.
+**/
+static const char* forth_get_fam(forth_t *o, forth_cell_t f)
+{
+	if (f >= LAST_FAM) {
 		error("Invalid file access method %"PRIdCell, f);
-		longjmp(*on_error, RECOVERABLE);
+		o->fault = THROW_FILE_IO;
+		return NULL;
 	}
 	return fams[f];
 }
@@ -1538,6 +4798,49 @@ void forth_set_string_input(forth_t *o, const char *s)
 	forth_set_block_input(o, s, strlen(s) + 1);
 }
 
+int forth_feed(forth_t *o, const char *s, size_t length)
+{
+	assert(o);
+	forth_cell_t *m = o->m, unread = 0;
+	char *n;
+	if (!s)
+		length = 0;
+	if (m[EVAL_FRAME]) { /* a frame may point into the buffer */
+		error("cannot feed input part way through %s", "evaluate");
+		return -1;
+	}
+	if (m[SOURCE_ID] == (forth_cell_t)FEED_IN) {
+		if (o->feed && m[SIDX] <= m[SLEN] && m[SLEN] <= o->feed_size)
+			unread = m[SLEN] - m[SIDX];
+		if (unread)
+			memmove(o->feed, o->feed + m[SIDX], unread);
+	} else {
+		o->unget_set = false;
+	}
+	if (unread + length > o->feed_size) {
+		errno = 0;
+		if (!(n = realloc(o->feed, unread + length))) {
+			error("could not grow input buffer, %s", forth_strerror());
+			return -1;
+		}
+		o->feed = n;
+		o->feed_size = unread + length;
+	}
+	if (s)
+		memcpy(o->feed + unread, s, length);
+	m[SIN]       = (forth_cell_t)o->feed;
+	m[SIDX]      = 0;
+	m[SLEN]      = unread + length;
+	m[SOURCE_ID] = s ? FEED_IN : STRING_IN;
+	return 0;
+}
+
+enum forth_status forth_status(forth_t *o)
+{
+	assert(o);
+	return forth_is_invalid(o) ? FORTH_STATUS_INVALID : o->status;
+}
+
 int forth_eval_block(forth_t *o, const char *s, size_t length)
 {
 	assert(o);
@@ -1586,6 +4889,12 @@ void forth_invalidate(forth_t *o)
 	o->m[INVALID] = 1;
 }
 
+void forth_set_budget(forth_t *o, forth_cell_t budget)
+{
+	assert(o);
+	o->budget = budget;
+}
+
 void forth_set_debug_level(forth_t *o, enum forth_debug_level level)
 {
 	assert(o);
@@ -1630,11 +4939,12 @@ static void forth_make_default(forth_t *o, size_t size, FILE *in, FILE *out)
 
 	o->s             = (uint8_t*)(o->m + STRING_OFFSET); /*skip registers*/
 	o->m[FOUT]       = (forth_cell_t)out;
-	o->m[START_ADDR] = (forth_cell_t)&(o->m);
+	o->m[START_ADDR] = (forth_cell_t)o->m;
 	o->m[STDIN]      = (forth_cell_t)stdin;
 	o->m[STDOUT]     = (forth_cell_t)stdout;
 	o->m[STDERR]     = (forth_cell_t)stderr;
 	o->m[RSTK] = size - o->m[STACK_SIZE]; /* set up return stk ptr */
+	o->m[RESUME] = 0;
 	o->m[ARGC] = o->m[ARGV] = 0;
 	o->S       = o->m + size - (2 * o->m[STACK_SIZE]); /* v. stk pointer */
 	o->vstart  = o->m + size - (2 * o->m[STACK_SIZE]);
@@ -1693,6 +5003,7 @@ forth_t *forth_init(size_t size, FILE *in, FILE *out,
 	assert(in);
 	assert(out);
 	BUILD_BUG_ON(sizeof(forth_cell_t) < sizeof(uintptr_t));
+	BUILD_BUG_ON(TRACE_RING_SIZE & (TRACE_RING_SIZE - 1));
 	size = forth_round_up_pow2(size);
 	pow  = forth_blog2(size);
 /**
@@ -1701,8 +5012,9 @@ which is not apparent in its definition (and cannot be made apparent given
 how flexible array members work). We need enough memory to store the registers
 (32 cells), the parse area for a word (**MAXIMUM_WORD_LENGTH** cells), the 
 initial start up program (about 6 cells), the initial built in and defined 
-word set (about 600-700 cells) and the variable and return stacks 
-(**MINIMUM_STACK_SIZE** cells each, as minimum).
+word set (about 1900 cells, most of which are the headers of the built in
+words) and the variable and return stacks (**MINIMUM_STACK_SIZE** cells
+each, as minimum).
 
 If we add these together we come up with an absolute minimum, although
 that would not allow us define new words or do anything useful. We use
@@ -1720,6 +5032,7 @@ and should be informed of this problem.
 	VERIFY(size >= MINIMUM_CORE_SIZE);
 	if (!(o = calloc(1, sizeof(*o) + sizeof(forth_cell_t)*size)))
 		return NULL;
+	o->m = (forth_cell_t*)(o + 1);
 
 /** 
 Default the registers, and input and output streams:
@@ -1767,15 +5080,59 @@ restore when we enter **forth_run**.
 	m[m[DIC]++] = t;    /* call to TAIL */
 	m[m[DIC]++] = o->m[INSTRUCTION] - 1; /* recurse */
 
+/**
+**CATCH** needs a thread to return to when the word it executes returns
+normally, the register **CATCH_EXIT** is used as that thread, it points
+to a cell containing the **UNCATCH** instruction.
+**/
+	m[CATCH_EXIT] = m[DIC];
+	m[m[DIC]++] = UNCATCH;
+
+/**
+The interpreter runs as the first task, and its task control block is
+made here. It only needs space to save its state in and for its user
+variables, as it uses the stacks at the end of the core.
+**/
+	w = m[DIC];
+	m[DIC] += TASK_USER + TASK_USER_SIZE;
+	m[w + TASK_LINK]   = w;
+	m[w + TASK_STATUS] = 1;
+	m[w + TASK_VSTART] = o->vstart - m;
+	m[w + TASK_VEND]   = o->vend - m;
+	m[w + TASK_RSTART] = o->core_size - m[STACK_SIZE];
+	m[w + TASK_REND]   = o->core_size - RSTK_SPARE;
+	m[RSTK_END]        = m[w + TASK_REND];
+	m[TASK] = m[MAIN_TASK] = w;
+
+/**
+Every word has to be in a wordlist, so the first wordlist, which will be
+returned by **forth-wordlist**, is made before any words are. It is the
+wordlist new words are added to and the only one searched to start with.
+**/
+	w = m[DIC];
+	m[DIC] += WORDLIST_SIZE;
+	m[WORDLISTS] = m[CURRENT] = m[CONTEXT] = w;
+	m[ORDER] = 1;
+
+/**
+The floating point stack is kept in the dictionary, rather than with
+the other stacks, so that it can be saved to, and loaded from, a core
+file along with everything else.
+**/
+	m[FLOAT_STACK] = m[DIC];
+	m[DIC] += FLOAT_STACK_SIZE * FLOAT_CELLS;
+	m[FLOAT_DEPTH] = 0;
+	m[PRECISION] = 15;
+
 /**
 **DEFINE** and **IMMEDIATE** are two immediate words, the only two immediate
 words that are also virtual machine instructions, we can make them
 immediate by passing in their code word to **compile**. The created
 word looks like this:
 
-	.------.-----.------.
-	| NAME | PWD | CODE |
-	.------.-----.------.
+	.--------.-----.------.-----.------.
+	| THREAD | KEY | NAME | PWD | CODE |
+	.--------.-----.------.-----.------.
 
 The **CODE** field here contains either **DEFINE** or **IMMEDIATE**, as well as
 the hidden bit field and an offset to the beginning of name. The compiling bit
@@ -1799,12 +5156,32 @@ compile pointers to this CODE field into the dictionary.
 	compile(o, EXIT, "_exit", true, false); /* needed for 'see', trust me */
 	compile(o, PUSH, "'", true, false); /* crude starting version of ' */
 
+/**
+The floating point words are made like constants, but with **FLOAT** in
+their code field and the operation it should perform in their body. The
+execution token of **(fliteral)** is kept so **READ** can compile it.
+**/
+	for (i = 0; float_names[i]; i++) {
+		w = compile(o, FLOAT, float_names[i], true, false);
+		if (i == FLIT)
+			m[FLITERAL] = w;
+		m[m[DIC]++] = i;
+	}
+	for (i = 0; bignum_names[i]; i++) {
+		compile(o, BIGNUM, bignum_names[i], true, false);
+		m[m[DIC]++] = i;
+	}
+	for (i = 0; regex_names[i]; i++) {
+		compile(o, REGEX, regex_names[i], true, false);
+		m[m[DIC]++] = i;
+	}
+
 /**
 We now name all the registers so we can refer to them by name instead of by
 number.
 **/
 	for (i = 0; register_names[i]; i++)
-		VERIFY(forth_define_constant(o, register_names[i], i+DIC) >= 0);
+		VERIFY(forth_define_constant(o, register_names[i], register_values[i]) >= 0);
 
 /**
 More constants are now defined:
@@ -1842,8 +5219,10 @@ int forth_dump_core(forth_t *o, FILE *dump)
 {
 	assert(o);
        	assert(dump);
-	size_t w = sizeof(*o) + sizeof(forth_cell_t) * o->core_size;
-	return w != fwrite(o, 1, w, dump) ? -1: 0;
+	size_t w = sizeof(forth_cell_t) * o->core_size;
+	if (sizeof(*o) != fwrite(o, 1, sizeof(*o), dump))
+		return -1;
+	return w != fwrite(o->m, 1, w, dump) ? -1: 0;
 }
 
 /** 
@@ -1856,8 +5235,12 @@ int forth_save_core_file(forth_t *o, FILE *dump)
 {
 	assert(o && dump);
 	uint64_t r1, r2, core_size = o->core_size;
+	uint32_t crc;
 	if (forth_is_invalid(o))
 		return -1;
+	crc = forth_crc32c(0, o->m, sizeof(forth_cell_t) * core_size);
+	for (int i = 0; i < 4; i++)
+		o->header[CHECKSUM0 + i] = crc >> (i * 8);
 	r1 = fwrite(o->header,  1, sizeof(o->header), dump);
 	r2 = fwrite(o->m,       1, sizeof(forth_cell_t) * core_size, dump);
 	if (r1+r2 != (sizeof(o->header) + sizeof(forth_cell_t) * core_size))
@@ -1875,8 +5258,12 @@ are correct and compatible with this interpreter.
 
 **forth_make_default** is called to replace any instances of pointers stored
 in registers which are now invalid after we have loaded the file from disk.
+
+If *verify* is true the checksum saved in the header must also match the
+core that was read in, so a corrupted file is rejected here instead of
+causing a crash later on.
 **/
-forth_t *forth_load_core_file(FILE *dump)
+static forth_t *forth_load_core(FILE *dump, bool verify)
 { 
 	uint8_t actual[sizeof(header)] = {0},   /* read in header */
 		expected[sizeof(header)] = {0}; /* what we expected */
@@ -1887,7 +5274,7 @@ forth_t *forth_load_core_file(FILE *dump)
 	if (sizeof(actual) != fread(actual, 1, sizeof(actual), dump)) {
 		goto fail; /* no header */
 	}
-	if (memcmp(expected, actual, sizeof(header)-1)) {
+	if (memcmp(expected, actual, LOG2_SIZE)) {
 		goto fail; /* invalid or incompatible header */
 	}
 	core_size = 1 << actual[LOG2_SIZE];
@@ -1902,11 +5289,21 @@ forth_t *forth_load_core_file(FILE *dump)
 		error("allocation of size %"PRId64" failed, %s", w, forth_strerror());
 		goto fail; 
 	}
+	o->m = (forth_cell_t*)(o + 1);
 	w = sizeof(forth_cell_t) * core_size;
 	if (w != fread(o->m, 1, w, dump)) {
 		error("file too small (expected %"PRId64")", w);
 		goto fail;
 	}
+	if (verify) {
+		uint32_t crc = forth_crc32c(0, o->m, w), saved = 0;
+		for (int i = 0; i < 4; i++)
+			saved |= (uint32_t)actual[CHECKSUM0 + i] << (i * 8);
+		if (crc != saved) {
+			error("checksum mismatch (expected %08"PRIx32", got %08"PRIx32")", saved, crc);
+			goto fail;
+		}
+	}
 	o->core_size = core_size;
 	memcpy(o->header, actual, sizeof(o->header));
 	forth_make_default(o, core_size, stdin, stdout);
@@ -1916,6 +5313,16 @@ fail:
 	return NULL;
 }
 
+forth_t *forth_load_core_file(FILE *dump)
+{
+	return forth_load_core(dump, false);
+}
+
+forth_t *forth_load_verified_core_file(FILE *dump)
+{
+	return forth_load_core(dump, true);
+}
+
 /**
 The following function allows us to load a core file from memory:
 **/
@@ -1933,12 +5340,39 @@ forth_t *forth_load_core_memory(char *m, size_t size)
 				sizeof(*o) + size, forth_strerror());
 		return NULL;
 	}
+	o->m = (forth_cell_t*)(o + 1);
 	make_header(o->header, forth_blog2(size));
 	memcpy(o->m, m + offset, size);
 	forth_make_default(o, size / sizeof(forth_cell_t), stdin, stdout);
 	return o;
 }
 
+/**
+Loading a core from memory copies it, which is wasteful when the memory
+could be used as it is, such as when a core compiled into a program has
+been mapped copy-on-write. This function makes a Forth object that uses
+an image of the core, which has no header, in place. The image is not
+owned by the object, so **forth_free** does not free it.
+**/
+forth_t *forth_load_core_image(forth_cell_t *m, size_t size)
+{
+	assert(m);
+	forth_t *o;
+	if (size < MINIMUM_CORE_SIZE || (size & (size - 1))) {
+		error("invalid core image size %zu", size);
+		return NULL;
+	}
+	errno = 0;
+	if (!(o = calloc(sizeof(*o), 1))) {
+		error("allocation of size %zu failed, %s", sizeof(*o), forth_strerror());
+		return NULL;
+	}
+	o->m = m;
+	make_header(o->header, forth_blog2(size));
+	forth_make_default(o, size, stdin, stdout);
+	return o;
+}
+
 /**
 And likewise we will want to be able to save to memory as well, the
 load and save functions for memory expect headers *not* to be present.
@@ -1957,7 +5391,7 @@ char *forth_save_core_memory(forth_t *o, size_t *size)
 		return NULL;
 	}
 	memcpy(m, o->header, sizeof(o->header)); /* copy header */
-	memcpy(m + sizeof(o->header), o->m, w); /* core */
+	memcpy(m + sizeof(o->header), o->m, w * sizeof(forth_cell_t)); /* core */
 	*size = o->core_size * sizeof(forth_cell_t) + sizeof(o->header);
 	return m;
 }
@@ -1972,6 +5406,8 @@ void forth_free(forth_t *o)
 	/* invalidate the forth core, a sufficiently "smart" compiler 
 	 * might optimize this out */
 	forth_invalidate(o);
+	free(o->feed);
+	free(o->profile);
 	free(o);
 }
 
@@ -2048,6 +5484,7 @@ void forth_signal(forth_t *o, int sig)
 {
 	assert(o);
 	o->m[SIGNAL_HANDLER] = (forth_cell_t)((sig * -1) + BIAS_SIGNAL);
+	o->fault = o->m[SIGNAL_HANDLER];
 }
 
 char *forth_strdup(const char *s)
@@ -2077,29 +5514,715 @@ char **forth_words(forth_t *o, size_t *length)
 	char **n, **s = calloc(2, sizeof(*s));
 	if (!s)
 		return NULL;
-	for (i = 0 ;pwd > DICTIONARY_START; pwd = m[pwd], i++) {
+	for (i = 0 ;pwd > DICTIONARY_START; pwd = m[pwd]) {
 		forth_cell_t len = WORD_LENGTH(m[pwd + 1]);
+		if (!forth_in_order(o, pwd))
+			continue;
 		s[i] = forth_strdup((char*)(&m[pwd-len]));
 		if (!s[i]) {
 			forth_free_words(s, i);
 			*length = 0;
 			return NULL;
 		}
-		n = realloc(s, sizeof(*s) * (i+2));
-		if (!n) {
-			forth_free_words(s, i);
-			*length = 0;
-			return NULL;
+		n = realloc(s, sizeof(*s) * (i+2));
+		if (!n) {
+			forth_free_words(s, i);
+			*length = 0;
+			return NULL;
+		}
+		s = n;
+		i++;
+	}
+	*length = i;
+	return s;
+}
+
+/**
+## Ahead of Time Translation to C
+
+Threaded code is compact and simple, but every word executed costs a trip
+through the dispatch loop in **forth_run**. Once a core has been built, and
+the interpreter is not going to change much, the bodies of the words
+within it can be translated into C and compiled into the executable, this
+is what **forth_native_translate** does. The translated functions are then
+handed back to a running interpreter with **forth_set_native**, and the
+**RUN** instruction will call them in preference to interpreting the word
+body.
+
+The translation is a simple one, each cell in a words body becomes a few
+lines of C, branches become **goto** statements, calls to other translated
+words become C function calls and a small set of simple instructions are
+written out inline. Anything more complex (such as **READ**, or the file
+access words) is not translated, instead the translated code gives up,
+saving the stack and the instruction pointer so the virtual machine can
+carry on where it left off. This is called a deoptimization.
+
+As Forth code is free to modify itself, or redefine words with **make**
+or **is**, each cell translated is guarded by a check that it has not
+changed since translation, a failed check also results in a
+deoptimization, so translated code can never behave differently from the
+interpreter. Literals are always read from the core, not baked into the
+generated code. The depth of the variable stack is checked before each
+cell as the interpreter checks it before each instruction, with the
+same **stack_bounds** table, and a failed check deoptimizes so that the
+interpreter can throw the underflow or overflow error.
+**/
+
+/**
+Simple instructions that can be written out inline, **check** is a
+condition that if true means the instruction would fail in the
+interpreter, and it should be given the chance to report an error.
+**/
+static const struct native_instruction {
+	enum instructions w; /**< instruction translated */
+	const char *check;   /**< condition that causes a deoptimization */
+	const char *body;    /**< C code implementing the instruction */
+} native_instructions[] = {
+	{ LOAD,    "f >= CORE",        "f = m[f];" },
+	{ STORE,   "f >= CORE",        "m[f] = *S--; f = *S--;" },
+	{ CLOAD,   "f >= CORE_BYTES",  "f = ((uint8_t*)m)[f];" },
+	{ CSTORE,  "f >= CORE_BYTES",  "((uint8_t*)m)[f] = *S--; f = *S--;" },
+	{ SUB,     NULL,               "f = *S-- - f;" },
+	{ ADD,     NULL,               "f = *S-- + f;" },
+	{ AND,     NULL,               "f = *S-- & f;" },
+	{ OR,      NULL,               "f = *S-- | f;" },
+	{ XOR,     NULL,               "f = *S-- ^ f;" },
+	{ INV,     NULL,               "f = ~f;" },
+	{ SHL,     NULL,               "f = *S-- << f;" },
+	{ SHR,     NULL,               "f = *S-- >> f;" },
+	{ MUL,     NULL,               "f = *S-- * f;" },
+	{ DIV,     "!f",               "f = *S-- / f;" },
+	{ ULESS,   NULL,               "f = *S-- < f;" },
+	{ UMORE,   NULL,               "f = *S-- > f;" },
+	{ EQUAL,   NULL,               "f = *S-- == f;" },
+	{ EMIT,    NULL,               "f = fputc(f, (FILE*)m[FOUT]);" },
+	{ FROMR,   "m[RSTK] >= CORE",  "*++S = f; f = m[m[RSTK]--];" },
+	{ TOR,     "m[RSTK] + 1 >= m[REND]", "m[++m[RSTK]] = f; f = *S--;" },
+	{ SWAP,    NULL,               "w = f; f = *S--; *++S = w;" },
+	{ DUP,     NULL,               "*++S = f;" },
+	{ DROP,    NULL,               "f = *S--;" },
+	{ OVER,    NULL,               "w = *S; *++S = f; f = w;" },
+	{ SPLOAD,  NULL,               "*++S = f; f = (forth_cell_t)(S - m);" },
+	{ SPSTORE, NULL,               "w = *S; S = m + f - 1; f = w;" },
+	{ LAST_INSTRUCTION, NULL, NULL }
+};
+
+/**
+How each cell within a words body is translated:
+**/
+enum native_kind {
+	NATIVE_DEOPT,  /**< not translated, return to the interpreter */
+	NATIVE_SIMPLE, /**< an entry in **native_instructions** */
+	NATIVE_PUSH,   /**< push the literal in the next cell */
+	NATIVE_CONST,  /**< push a constant */
+	NATIVE_CALL,   /**< call another translated word */
+	NATIVE_BRANCH, /**< unconditional branch */
+	NATIVE_QBRANCH,/**< conditional branch */
+	NATIVE_EXIT    /**< return from the word */
+};
+
+/**
+A translation context, there are three arrays each the size of the
+core being translated, **body** marks the cells which begin a words
+body (the address after a **RUN** instruction), **owner** records which
+walk of a body a cell was last visited in, and **label** records
+whether a cell needs to be jumped to.
+**/
+struct native_context {
+	forth_t *o;           /**< the core being translated */
+	FILE *out;            /**< where to write the C code to */
+	uint8_t *body;        /**< cells that start a words body */
+	forth_cell_t *owner;  /**< walk that has visited a cell */
+	forth_cell_t walks;   /**< number of walks made */
+	uint8_t *label;       /**< cells that are jumped to */
+	forth_cell_t *visit;  /**< cells visited in this body */
+	forth_cell_t visited; /**< number of cells in **visit** */
+	forth_cell_t *bodies; /**< list of bodies to translate */
+	forth_cell_t count;   /**< number of bodies found */
+	forth_cell_t *stack;  /**< work list used when walking a body */
+};
+
+static enum native_kind native_classify(forth_t *o, forth_cell_t p, 
+		const struct native_instruction **simple)
+{
+	forth_cell_t *m = o->m, size = o->core_size, x, w, t;
+	if (p >= size - 1 || (x = m[p]) == 0 || x >= size - 1)
+		return NATIVE_DEOPT;
+	w = instruction(m[x]);
+	switch (w) {
+	case PUSH:  return p + 2 < size ? NATIVE_PUSH : NATIVE_DEOPT;
+	case CONST: return NATIVE_CONST;
+	case RUN:   return NATIVE_CALL;
+	case EXIT:  return NATIVE_EXIT;
+	case BRANCH:
+	case QBRANCH:
+		t = p + 1 + m[p + 1];
+		if (t >= size || (w == QBRANCH && p + 2 >= size))
+			return NATIVE_DEOPT;
+		return w == BRANCH ? NATIVE_BRANCH : NATIVE_QBRANCH;
+	}
+	for (*simple = native_instructions; (*simple)->body; (*simple)++)
+		if ((*simple)->w == w)
+			return NATIVE_SIMPLE;
+	return NATIVE_DEOPT;
+}
+
+/**
+**native_fallthrough** returns the cell executed after the one at
+**p** if no branch is taken, or zero if execution does not continue
+on to the next cell. **native_classify** only accepts cells whose
+fall through is within the core.
+**/
+static forth_cell_t native_fallthrough(enum native_kind kind, forth_cell_t p)
+{
+	switch (kind) {
+	case NATIVE_PUSH:
+	case NATIVE_QBRANCH: return p + 2;
+	case NATIVE_SIMPLE:
+	case NATIVE_CONST:
+	case NATIVE_CALL:    return p + 1;
+	default:             return 0;
+	}
+}
+
+static void native_add_body(struct native_context *c, forth_cell_t b)
+{
+	if (b >= c->o->core_size || c->body[b])
+		return;
+	c->body[b] = 1;
+	c->bodies[c->count++] = b;
+}
+
+static int native_compare(const void *a, const void *b)
+{
+	forth_cell_t x = *(const forth_cell_t*)a, y = *(const forth_cell_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+**native_walk** finds every cell reachable from the start of a body,
+along with the cells that need labels, and any new bodies that are
+called from it.
+**/
+static void native_walk(struct native_context *c, forth_cell_t b)
+{
+	forth_cell_t *m = c->o->m, i, p, n, *stack = c->stack, sp = 0;
+	const struct native_instruction *simple = NULL;
+	c->visited = 0;
+	c->walks++;
+	stack[sp++] = b;
+	while (sp) {
+		p = stack[--sp];
+		if (c->owner[p] == c->walks)
+			continue;
+		c->owner[p] = c->walks;
+		c->label[p] = 0;
+		c->visit[c->visited++] = p;
+		enum native_kind kind = native_classify(c->o, p, &simple);
+		if ((n = native_fallthrough(kind, p)))
+			stack[sp++] = n;
+		if (kind == NATIVE_BRANCH || kind == NATIVE_QBRANCH)
+			stack[sp++] = p + 1 + m[p + 1];
+	}
+	qsort(c->visit, c->visited, sizeof(c->visit[0]), native_compare);
+	for (i = 0; i < c->visited; i++) {
+		p = c->visit[i];
+		enum native_kind kind = native_classify(c->o, p, &simple);
+		if (kind == NATIVE_BRANCH || kind == NATIVE_QBRANCH)
+			c->label[p + 1 + m[p + 1]] = 1;
+		if ((n = native_fallthrough(kind, p)))
+			if (i + 1 == c->visited || c->visit[i + 1] != n)
+				c->label[n] = 1;
+		if (kind == NATIVE_CALL)
+			native_add_body(c, m[p] + 1);
+	}
+	if (c->visit[0] != b)
+		c->label[b] = 1;
+}
+
+/**
+**native_emit** writes out the C function for a single body, it
+must have been walked with **native_walk** first.
+**/
+static void native_emit(struct native_context *c, forth_cell_t b)
+{
+	FILE *out = c->out;
+	forth_cell_t *m = c->o->m, i, p, x, n;
+	int depth;
+	const struct native_instruction *simple = NULL;
+	fprintf(out, "\nstatic int forth_native_%"PRIdCell"(struct forth_native_state *st)\n{\n", b);
+	fputs("\tforth_cell_t *m = st->m, *S = st->S, f = st->f, w = 0;\n\t(void)m;\n\t(void)w;\n", out);
+	if (c->visit[0] != b)
+		fprintf(out, "\tgoto L%"PRIdCell";\n", b);
+	for (i = 0; i < c->visited; i++) {
+		p = c->visit[i];
+		x = m[p];
+		enum native_kind kind = native_classify(c->o, p, &simple);
+		if (c->label[p])
+			fprintf(out, "L%"PRIdCell":\n", p);
+		if (kind != NATIVE_DEOPT && (depth = stack_bounds[instruction(m[x])]))
+			fprintf(out, "\tDEPTH(%"PRIdCell", %d);\n", p, depth);
+		else if (kind != NATIVE_DEOPT)
+			fprintf(out, "\tHEIGHT(%"PRIdCell");\n", p);
+		switch (kind) {
+		case NATIVE_DEOPT:
+			fprintf(out, "\tDEOPT(%"PRIdCell");\n", p);
+			break;
+		case NATIVE_SIMPLE:
+			fprintf(out, "\tif (m[%"PRIdCell"] != %"PRIdCell"%s%s) DEOPT(%"PRIdCell");\n\t%s\n",
+				p, x, simple->check ? " || " : "", 
+				simple->check ? simple->check : "", p, simple->body);
+			break;
+		case NATIVE_PUSH:
+			fprintf(out, "\tif (m[%"PRIdCell"] != %"PRIdCell") DEOPT(%"PRIdCell");\n"
+				"\t*++S = f; f = m[%"PRIdCell"];\n", p, x, p, p + 1);
+			break;
+		case NATIVE_CONST:
+			fprintf(out, "\tif (m[%"PRIdCell"] != %"PRIdCell" || (m[%"PRIdCell"] & MASK) != %d) DEOPT(%"PRIdCell");\n"
+				"\t*++S = f; f = m[%"PRIdCell"];\n", p, x, x, CONST, p, x + 1);
+			break;
+		case NATIVE_CALL:
+			fprintf(out, "\tif (m[%"PRIdCell"] != %"PRIdCell" || (m[%"PRIdCell"] & MASK) != %d || m[RSTK] + 1 >= m[REND]) DEOPT(%"PRIdCell");\n"
+				"\tPOLL(%"PRIdCell", %d);\n"
+				"\tm[++m[RSTK]] = %"PRIdCell"; st->S = S; st->f = f;\n"
+				"\tif (forth_native_%"PRIdCell"(st) || st->I != %"PRIdCell") return 1;\n"
+				"\tS = st->S; f = st->f;\n", 
+				p, x, x, RUN, p, p, RUN, p + 1, x + 1, p + 1);
+			break;
+		case NATIVE_BRANCH:
+		case NATIVE_QBRANCH:
+			fprintf(out, "\tif (m[%"PRIdCell"] != %"PRIdCell" || m[%"PRIdCell"] != %"PRIdCell"u) DEOPT(%"PRIdCell");\n"
+				"\tPOLL(%"PRIdCell", %d);\n",
+				p, x, p + 1, m[p + 1], p, p, kind == NATIVE_BRANCH ? BRANCH : QBRANCH);
+			if (kind == NATIVE_QBRANCH)
+				fprintf(out, "\tw = f; f = *S--; if (!w) goto L%"PRIdCell";\n", p + 1 + m[p + 1]);
+			else
+				fprintf(out, "\tgoto L%"PRIdCell";\n", p + 1 + m[p + 1]);
+			break;
+		case NATIVE_EXIT:
+			fprintf(out, "\tif (m[%"PRIdCell"] != %"PRIdCell" || m[RSTK] >= CORE) DEOPT(%"PRIdCell");\n"
+				"\tst->S = S; st->f = f; st->I = m[m[RSTK]--]; return 0;\n", p, x, p);
+			break;
+		}
+		if ((n = native_fallthrough(kind, p)))
+			if (i + 1 == c->visited || c->visit[i + 1] != n)
+				fprintf(out, "\tgoto L%"PRIdCell";\n", n);
+	}
+	fputs("}\n", out);
+}
+
+int forth_native_translate(forth_t *o, FILE *out)
+{
+	struct native_context c = { .o = o, .out = out };
+	forth_cell_t *m = o->m, size = o->core_size, pwd, i;
+	int rval = -1;
+	assert(o && out);
+	if (forth_is_invalid(o))
+		return -1;
+	errno = 0;
+	c.body   = calloc(size, sizeof(*c.body));
+	c.label  = calloc(size, sizeof(*c.label));
+	c.owner  = calloc(size, sizeof(*c.owner));
+	c.visit  = calloc(size, sizeof(*c.visit));
+	c.bodies = calloc(size, sizeof(*c.bodies));
+	c.stack  = calloc(2 * size, sizeof(*c.stack));
+	if (!c.body || !c.label || !c.owner || !c.visit || !c.bodies || !c.stack) {
+		error("allocation failed, %s", forth_strerror());
+		goto end;
+	}
+	for (pwd = m[PWD]; pwd > DICTIONARY_START && pwd < size - 2; pwd = m[pwd])
+		if (instruction(m[pwd + 1]) == RUN)
+			native_add_body(&c, pwd + 2);
+	for (i = 0; i < c.count; i++) /* find bodies called by other bodies */
+		native_walk(&c, c.bodies[i]);
+	qsort(c.bodies, c.count, sizeof(c.bodies[0]), native_compare);
+
+	fprintf(out, "/* Generated by forth_native_translate from a core of %"PRIdCell
+			" cells, do not edit */\n", size);
+	fputs("#include \"libforth.h\"\n", out);
+	fprintf(out, "#define CORE       (%"PRIdCell"u)\n", size);
+	fprintf(out, "#define CORE_BYTES (%"PRIdCell"u)\n", size * sizeof(forth_cell_t));
+	fprintf(out, "#define MASK       (0x%xu)\n", INSTRUCTION_MASK);
+	fprintf(out, "#define RSTK       (%d)\n", RSTK);
+	fprintf(out, "#define FOUT       (%d)\n", FOUT);
+	fprintf(out, "#define REND       (%d)\n", RSTK_END);
+	fputs("#define DEOPT(P) do { st->S = S; st->f = f; st->I = (P); return 1; } while (0)\n", out);
+	fputs("#define HEIGHT(P) do { if (S > st->vend) DEOPT(P); } while (0)\n", out);
+	fputs("#define DEPTH(P, N) do { if ((uintptr_t)(S - st->vstart) < (N)) DEOPT(P); HEIGHT(P); } while (0)\n", out);
+#if TRACE_RING_SIZE
+	fprintf(out, "#define SHIFT      (%uu)\n", TRACE_SHIFT);
+#else
+	fputs("#define SHIFT      (0u)\n", out);
+#endif
+	fputs("#define POLL(P, W) do { if (*st->fault || st->fuel <= 1) DEOPT(P);\\\n"
+	      "\tst->fuel--; if (st->ring) {\\\n"
+	      "\tforth_cell_t *t_ = st->ring[st->ring_next++ & st->ring_mask];\\\n"
+	      "\tt_[0] = (((forth_cell_t)(P) + 1) << SHIFT) | (W); t_[1] = f; } } while (0)\n\n", out);
+	for (i = 0; i < c.count; i++)
+		fprintf(out, "static int forth_native_%"PRIdCell"(struct forth_native_state *st);\n", c.bodies[i]);
+	for (i = 0; i < c.count; i++) {
+		native_walk(&c, c.bodies[i]);
+		native_emit(&c, c.bodies[i]);
+	}
+	fputs("\nconst struct forth_native forth_native_table[] = {\n", out);
+	for (i = 0; i < c.count; i++)
+		fprintf(out, "\t{ %"PRIdCell", forth_native_%"PRIdCell" },\n", c.bodies[i], c.bodies[i]);
+	fputs("};\n\n", out);
+	fprintf(out, "const size_t forth_native_count = %"PRIdCell";\n", c.count);
+	fprintf(out, "const forth_cell_t forth_native_core_size = %"PRIdCell";\n", size);
+	rval = ferror(out) ? -1 : 0;
+end:
+	free(c.body);
+	free(c.label);
+	free(c.owner);
+	free(c.visit);
+	free(c.bodies);
+	free(c.stack);
+	return rval;
+}
+
+int forth_set_native(forth_t *o, const struct forth_native *natives, 
+		size_t count, forth_cell_t core_size)
+{
+	assert(o && (natives || !count));
+	if (core_size != o->core_size)
+		return -1;
+	o->natives = natives;
+	o->native_count = count;
+	return 0;
+}
+
+/**
+**forth_native_find** looks up a translated body using a binary search
+of the table passed to **forth_set_native**.
+**/
+static forth_native_t forth_native_find(forth_t *o, forth_cell_t pc)
+{
+	size_t low = 0, high = o->native_count;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		forth_cell_t x = o->natives[mid].pc;
+		if (x == pc)
+			return o->natives[mid].function;
+		if (x < pc)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return NULL;
+}
+
+/**
+## The Forth Virtual Machine
+**/
+
+/**
+**EVALUATOR** does not call **forth_run** recursively, instead it saves the
+current input source in a frame on the return stack, along with the
+instruction pointer to return to, and the virtual machine carries on
+reading from the new source. The register **EVAL_FRAME** points to the
+innermost of these frames:
+
+	.-------------.-----------.-----.------.------.-----.------------.
+	| Instruction | SOURCE_ID | SIN | SIDX | SLEN | FIN | EVAL_FRAME | 0 |
+	.-------------.-----------.-----.------.------.-----.------------.---.
+	                                                          ^
+	                                                          |
+	                                                 m[EVAL_FRAME]
+
+The last cell stands in for the call to the interpreter loop, which
+begins with **TAIL** and so removes the cell on top of the return stack,
+see *forth_init*. Without it the loop would overwrite the saved
+**EVAL_FRAME** when it calls itself.
+
+**evaluate_pop** removes the innermost frame, restoring the input source,
+and returns the saved instruction pointer. It is called when the input
+ends, and when an exception is thrown past the frame.
+**/
+static forth_cell_t evaluate_pop(forth_t *o)
+{
+	forth_cell_t *m = o->m, e = m[EVAL_FRAME];
+	m[EVAL_FRAME] = m[e];
+	m[FIN]        = m[e - 1];
+	m[SLEN]       = m[e - 2];
+	m[SIDX]       = m[e - 3];
+	m[SIN]        = m[e - 4];
+	m[SOURCE_ID]  = m[e - 5];
+	m[RSTK]       = e - 7;
+	o->unget_set  = false;
+	return m[e - 6];
+}
+
+/**
+**return_stack_start** returns the bottom of the return stack of the
+current task, see **enum task_fields**.
+**/
+static forth_cell_t return_stack_start(forth_t *o)
+{
+	forth_cell_t t = o->m[TASK];
+	return t ? o->m[t + TASK_RSTART] : o->core_size - o->m[STACK_SIZE];
+}
+
+/**
+**forth_nanoseconds** reads a clock that only ever goes forward, for timing
+how long something takes, rather than finding out what time it is. C99
+only has **clock**, which measures processor time with a coarse resolution,
+so that is only used if the POSIX **clock_gettime** is not available.
+**/
+static forth_cell_t forth_nanoseconds(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec t;
+	if (!clock_gettime(CLOCK_MONOTONIC, &t))
+		return (forth_cell_t)t.tv_sec * 1000000000u + t.tv_nsec;
+#endif
+	return (forth_cell_t)(clock() * (1e9 / CLOCKS_PER_SEC));
+}
+
+/**
+**forth_cycles** reads the processors time stamp counter, on the 
+architectures where it is known how to, otherwise it falls back to
+**forth_nanoseconds**. The counter might not tick at the same rate as the 
+processor clock on modern processors, and is not synchronized between 
+cores, so it is only useful for timing short sections of code.
+**/
+static forth_cell_t forth_cycles(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	uint32_t low, high;
+	__asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+	return (forth_cell_t)(((uint64_t)high << 32) | low);
+#elif defined(__GNUC__) && defined(__aarch64__)
+	uint64_t v;
+	__asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (v));
+	return (forth_cell_t)v;
+#else
+	return forth_nanoseconds();
+#endif
+}
+
+/**
+## The Sampling Profiler
+
+The profiler takes samples of the return stack, which are turned into a
+list of words being executed when the samples are written out. Taking a 
+sample has to be safe to do from a signal handler, so it does no more
+than copy the innermost **PROFILE_DEPTH** cells of the return stack into
+a ring buffer, the oldest samples being overwritten when it is full. Each
+sample is laid out as:
+
+	.-------.---------.------------------------------.
+	| Depth | READ_XT | Return stack cells ...       |
+	.-------.---------.------------------------------.
+
+The cells on the return stack are not all return addresses, loop 
+counters and catch frames are kept there as well, so only cells that point
+just after a call to a word are treated as part of the call stack. The 
+word a return address points into is the caller and the word called 
+before it is the callee, so the innermost return address gives the word
+currently executing, unless it was executed by **READ**, whose last word
+is stored in **read_xt**.
+**/
+#define PROFILE_DEPTH (32u)
+#define PROFILE_SAMPLE (PROFILE_DEPTH + 2u)
+
+int forth_profile(forth_t *o, size_t samples)
+{
+	assert(o);
+	forth_cell_t *p = NULL;
+	errno = 0;
+	if (samples && !(p = calloc(samples, PROFILE_SAMPLE * sizeof(*p)))) {
+		error("profile allocation failed, %s", forth_strerror());
+		return -1;
+	}
+	o->m[PROFILING]  = 0; /* no samples are taken while changing buffers */
+	free(o->profile);
+	o->profile       = p;
+	o->profile_size  = samples;
+	o->profile_next  = 0;
+	o->profile_count = 0;
+	o->m[PROFILING]  = !!samples;
+	return 0;
+}
+
+void forth_profile_sample(forth_t *o)
+{
+	assert(o);
+	forth_cell_t *m = o->m, *p, r = m[RSTK], start = return_stack_start(o);
+	forth_cell_t i, depth;
+	if (!o->m[PROFILING] || !o->profile || r <= start || r >= o->core_size)
+		return;
+	depth = r - start > PROFILE_DEPTH ? PROFILE_DEPTH : r - start;
+	p = o->profile + (o->profile_next * PROFILE_SAMPLE);
+	p[0] = depth;
+	p[1] = o->read_xt;
+	for (i = 0; i < depth; i++)
+		p[2 + i] = m[r - depth + 1 + i];
+	o->profile_next = (o->profile_next + 1) % o->profile_size;
+	if (o->profile_count < o->profile_size)
+		o->profile_count++;
+}
+
+/**
+**profile_word** finds the word an address is in by walking the dictionary
+from the latest definition, returning the address of its **PWD** field, or
+zero if the address is not in a word.
+**/
+static forth_cell_t profile_word(forth_t *o, forth_cell_t addr)
+{
+	forth_cell_t *m = o->m, pwd = m[PWD];
+	for (; pwd > DICTIONARY_START; pwd = m[pwd])
+		if (pwd < addr)
+			return pwd;
+	return 0;
+}
+
+/**
+**profile_xt** returns the **PWD** field of the word an execution token
+belongs to, or zero if it is not an execution token.
+**/
+static forth_cell_t profile_xt(forth_t *o, forth_cell_t xt)
+{
+	forth_cell_t pwd;
+	if (xt <= DICTIONARY_START || xt >= o->m[DIC])
+		return 0;
+	pwd = profile_word(o, xt);
+	return pwd && pwd + 1 == xt ? pwd : 0;
+}
+
+/**
+**profile_frame** checks whether a cell from the return stack is a return
+address, that is whether the cell before it calls a word or is the call 
+to **READ** in the interpreter loop. The word called is put in **callee**,
+which is zero if it was called by **READ**.
+**/
+static int profile_frame(forth_t *o, forth_cell_t r, forth_cell_t *callee)
+{
+	forth_cell_t *m = o->m;
+	*callee = 0;
+	if (r <= DICTIONARY_START || r > m[DIC])
+		return 0;
+	if (m[r - 1] == m[m[INSTRUCTION]])
+		return 1;
+	return !!(*callee = profile_xt(o, m[r - 1]));
+}
+
+#define PROFILE_NAME(PWD) ((char*)(&m[(PWD) - WORD_LENGTH(m[(PWD) + 1])]))
+
+/**
+**profile_append** adds a name and a separator to a line of the profile,
+each frame of a sample can add two names (see *forth_profile_dump*), and
+names are cut short at **MAXIMUM_WORD_LENGTH** characters, so the length
+of a line is bounded even if the dictionary has been written over.
+**/
+#define PROFILE_LINE ((2 * PROFILE_DEPTH + 1) * (MAXIMUM_WORD_LENGTH + 1) + 1)
+
+static void profile_append(char *l, const char *name, const char *separator)
+{
+	strncat(l, name, MAXIMUM_WORD_LENGTH);
+	strcat(l, separator);
+}
+
+static int profile_compare(const void *a, const void *b)
+{
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+int forth_profile_dump(forth_t *o, FILE *out)
+{
+	assert(o);
+	assert(out);
+	forth_cell_t *m = o->m, *p, pwd, callee, c, i, j;
+	size_t n = o->profile_count, count;
+	char **lines, l[PROFILE_LINE];
+	int rval = 0;
+	if (!n)
+		return 0;
+	if (!(lines = calloc(n, sizeof(*lines))))
+		return -1;
+	for (i = 0; i < n; i++) {
+		l[0] = '\0';
+		p = o->profile + (i * PROFILE_SAMPLE);
+		for (callee = 0, j = 0; j < p[0]; j++) {
+			if (!profile_frame(o, p[2 + j], &c))
+				continue;
+			pwd = profile_word(o, p[2 + j]);
+			if (callee && callee != pwd) /* called by CATCH or similar */
+				profile_append(l, PROFILE_NAME(callee), ";");
+			if (pwd)
+				profile_append(l, PROFILE_NAME(pwd), ";");
+			callee = c;
+		}
+		if (!callee)
+			callee = profile_xt(o, p[1]);
+		profile_append(l, callee ? PROFILE_NAME(callee) : "?", "");
+		if (!(lines[i] = forth_strdup(l))) {
+			rval = -1;
+			goto end;
 		}
-		s = n;
 	}
-	*length = i;
-	return s;
+	qsort(lines, n, sizeof(*lines), profile_compare);
+	for (i = 0; i < n; i += count) {
+		for (count = 1; i + count < n && !strcmp(lines[i], lines[i + count]);)
+			count++;
+		if (fprintf(out, "%s %zu\n", lines[i], count) < 0)
+			rval = -1;
+	}
+end:
+	for (i = 0; i < n; i++)
+		free(lines[i]);
+	free(lines);
+	return rval;
 }
 
 /**
-## The Forth Virtual Machine
+## The Trace Ring Buffer
+
+Every call to a word and every branch is recorded in **trace_ring** by
+**TRACE_RING**, so when something goes wrong the last **TRACE_RING_SIZE**
+of them can be printed out after the fact, without the large slow down
+that comes with the **TRACE** output. The instructions executed in between
+can be worked out from the instruction pointer. The ring buffer is dumped
+by **RESTART** when it is called with an error, when the virtual machine
+is invalidated and by the **.trace** instruction. Printing it out does not
+allocate memory, so it can be done from a signal handler in an emergency,
+as *main.c* does when **SIGABRT** is raised, although if that happens in
+the middle of **forth_run** the newest entries are not yet counted in
+**trace_next** (see **TRACE_SYNC**) and will be printed as the oldest.
+
+Each line contains the instruction pointer, the word it points into, the
+instruction, the word being called if it is a call and the top of the
+stack, oldest first.
 **/
+void forth_trace_dump(forth_t *o, FILE *out)
+{
+	assert(o);
+	assert(out);
+#if TRACE_RING_SIZE
+	forth_cell_t *m = o->m, *t, I, w, pwd, callee;
+	size_t i = o->trace_next > TRACE_RING_SIZE ? 
+		o->trace_next - TRACE_RING_SIZE : 0;
+	fprintf(out, "trace of the last %zu calls and branches:\n", o->trace_next - i);
+	for (; i < o->trace_next; i++) {
+		t = o->trace_ring[i & (TRACE_RING_SIZE - 1)];
+		I = t[0] >> TRACE_SHIFT;
+		w = instruction(t[0]);
+		pwd = callee = 0;
+		if (I > DICTIONARY_START && I <= m[DIC]) {
+			pwd = profile_word(o, I - 1);
+			callee = w == RUN ? profile_xt(o, m[I - 1]) : 0;
+		}
+		fprintf(out, "\t%"PRIdCell"\t%-16s %-8s %-16s %"PRIdCell"\n", I, 
+			pwd ? PROFILE_NAME(pwd) : "?",
+			w < LAST_INSTRUCTION ? instruction_names[w] : "?",
+			callee ? PROFILE_NAME(callee) : "",
+			t[1]);
+	}
+	fflush(out);
+#else
+	(void)out;
+#endif
+}
 
 /**
 The largest function in the file, which implements the forth virtual
@@ -2107,63 +6230,55 @@ machine, everything else in this file is just fluff and support for this
 function. This is the Forth virtual machine, it implements a threaded
 code interpreter (see <https://en.wikipedia.org/wiki/Threaded_code>, and
 <https://www.complang.tuwien.ac.at/forth/threaded-code.html>).
+
+Entering the virtual machine costs very little, errors are not handled
+by jumping back to the entry point with **longjmp**, but by the code at
+the end of this function, see *on_fault*.
 **/
 int forth_run(forth_t *o)
 {
-	int errorval = 0, rval = 0;
+	int rval = 0;
 	assert(o);
-	jmp_buf on_error;
 	if (forth_is_invalid(o)) {
 		fatal("refusing to run an invalid forth, %"PRIdCell, forth_is_invalid(o));
 		return -1;
 	}
 
-	/* The following code handles errors, if an error occurs, the
-	 * interpreter will jump back to here.
-	 *
-	 * This code needs to be rethought to be made more compliant with
-	 * how "throw" and "catch" work in Forth. */
-	if ((errorval = setjmp(on_error)) || forth_is_invalid(o)) {
-		/* if the interpreter is invalid we always exit*/
-		if (forth_is_invalid(o))
-			return -1;
-		switch (errorval) {
-			default:
-			case FATAL:
-				forth_invalidate(o);
-				return -1;
-			/* recoverable errors depend on o->m[ERROR_HANDLER],
-			 * a register which can be set within the running
-			 * virtual machine. */
-			case RECOVERABLE:
-				switch (o->m[ERROR_HANDLER]) {
-				case ERROR_INVALIDATE: 
-					forth_invalidate(o);
-					/* fall-through */
-				case ERROR_HALT:       
-					return -forth_is_invalid(o);
-				case ERROR_RECOVER:    
-					o->m[RSTK] = o->core_size - o->m[STACK_SIZE];
-					break;
-				}
-			case OK: 
-				break;
-		}
-	}
-	
 	forth_cell_t *m = o->m,  /* convenience variable: virtual memory */
 		     pc,         /* virtual machines program counter */
 		     *S = o->S,  /* convenience variable: stack pointer */
 		     I = o->m[INSTRUCTION], /* instruction pointer */
 		     f = o->m[TOP], /* top of stack */
 		     w,          /* working pointer */
-		     clk;        /* clock variable */
+		     clk,        /* clock variable */
+		     e = o->m[EVAL_FRAME], /* evaluate frames below are not ours */
+		     fuel = o->budget ? o->budget : (forth_cell_t)-1; /* see POLL */
+#ifdef USE_STACK_CACHE
+	forth_cell_t s = 0;  /* second item on the stack, if cached */
+	forth_cell_t cached = 0; /* CACHED_STATE if s holds an item */
+#endif
+#if TRACE_RING_SIZE
+	size_t tn = o->trace_next; /* see TRACE_RING */
+#endif
 
 	assert(m);
 	assert(S);
+	o->fault = 0;
+	o->status = FORTH_STATUS_OK;
 
 	clk = (1000 * clock()) / CLOCKS_PER_SEC;
 
+/**
+If the last call returned before it was finished, see *suspend*, the
+instruction it stopped at is executed again.
+**/
+	if ((pc = m[RESUME])) {
+		m[RESUME] = 0;
+		I = m[ck(m[RSTK]--)];
+		e = m[ck(m[RSTK]--)];
+		goto INNER;
+	}
+
 /**
 The following section will explain how the threaded virtual machine interpreter
 works. Threaded code is a simple concept and Forths typically compile
@@ -2261,15 +6376,95 @@ other than **RUN**, they contain the instructions **DUP** and **MUL**
 respectively.
 
 **/
+run:
 	for (;(pc = m[ck(I++)]);) { 
 	INNER:  
 		w = instruction(m[ck(pc++)]);
+#if defined(USE_STACK_CACHE) && !defined(NDEBUG)
+		if (cached && m[DEBUG] >= FORTH_DEBUG_INSTRUCTION) {
+			*++S = s; /* spill so the trace shows the whole stack */
+			cached = 0;
+		}
+#endif
 		if (w < LAST_INSTRUCTION) {
 			cd(stack_bounds[w]);
 			TRACE(o, w, S, f);
 		}
+#ifndef NDEBUG
+		if (o->fault) /* a check failed, here or in the last instruction */
+			goto on_fault;
+#endif
 
-		switch (w) { 
+#ifdef USE_STACK_CACHE
+	REDISPATCH:
+#endif
+		switch (DISPATCH(w)) { 
+#ifdef USE_STACK_CACHE
+/**
+If **USE_STACK_CACHE** is defined the virtual machine has two states, in the
+first, like the normal virtual machine, only the top of the stack is held in
+**f** and the rest are in memory. In the second the second item on the stack
+is held in **s** as well and **cached** is set to **CACHED_STATE**, which
+selects a different set of cases in this switch statement. Literals and
+the stack shuffling instructions move into the second state, instructions
+that consume two items move back out of it, and neither has to touch the
+stack in memory to do so. Any instruction not handled in the second state
+spills **s** to memory and is dispatched again by the **default** case,
+so the rest of the virtual machine only has to deal with the first state.
+**/
+		case CACHED_STATE|PUSH:  *++S = s; s = f; f = m[ck(I++)]; break;
+		case CACHED_STATE|CONST: *++S = s; s = f; f = m[ck(pc)];  break;
+		case CACHED_STATE|RUN:
+			if (o->native_count) { /* translated words expect one state */
+				*++S = s;
+				cached = 0;
+				goto REDISPATCH; /* which polls */
+			}
+			POLL();
+			RCHECK(1);
+			m[ck(++m[RSTK])] = I; 
+			I = pc;
+			break;
+		case CACHED_STATE|LOAD:  f = m[ck(f)];                       break;
+		case CACHED_STATE|STORE: m[ck(f)] = s; f = *S--; cached = 0; break;
+		case CACHED_STATE|CLOAD: f = ((uint8_t*)m)[ckchar(f)];       break;
+		case CACHED_STATE|CSTORE: 
+			((uint8_t*)m)[ckchar(f)] = s; 
+			f = *S--; 
+			cached = 0; 
+			break;
+		case CACHED_STATE|SUB:   f = s - f;  cached = 0;             break;
+		case CACHED_STATE|ADD:   f = s + f;  cached = 0;             break;
+		case CACHED_STATE|AND:   f = s & f;  cached = 0;             break;
+		case CACHED_STATE|OR:    f = s | f;  cached = 0;             break;
+		case CACHED_STATE|XOR:   f = s ^ f;  cached = 0;             break;
+		case CACHED_STATE|INV:   f = ~f;                             break;
+		case CACHED_STATE|SHL:   f = s << f; cached = 0;             break;
+		case CACHED_STATE|SHR:   f = s >> f; cached = 0;             break;
+		case CACHED_STATE|MUL:   f = s * f;  cached = 0;             break;
+		case CACHED_STATE|ULESS: f = s < f;  cached = 0;             break;
+		case CACHED_STATE|UMORE: f = s > f;  cached = 0;             break;
+		case CACHED_STATE|EQUAL: f = s == f; cached = 0;             break;
+		case CACHED_STATE|EXIT:  I = m[ck(m[RSTK]--)];               break;
+		case CACHED_STATE|FROMR: *++S = s; s = f; f = m[ck(m[RSTK]--)]; break;
+		case CACHED_STATE|TOR:   
+			RCHECK(1);
+			m[ck(++m[RSTK])] = f; 
+			f = s; 
+			cached = 0; 
+			break;
+		case CACHED_STATE|BRANCH: POLL(); I += m[ck(I)];             break;
+		case CACHED_STATE|QBRANCH: 
+			POLL();
+			I += f == 0 ? m[I] : 1; 
+			f = s; 
+			cached = 0; 
+			break;
+		case CACHED_STATE|SWAP:  w = f; f = s; s = w;                break;
+		case CACHED_STATE|DUP:   *++S = s; s = f;                    break;
+		case CACHED_STATE|DROP:  f = s; cached = 0;                  break;
+		case CACHED_STATE|OVER:  *++S = s; w = s; s = f; f = w;      break;
+#endif
 
 /**
 When explaining words with example Forth code the
@@ -2277,9 +6472,43 @@ instructions enumeration will not be used (such as **ADD** or
 **SUB**), but its name will be used instead (such as **+** or **-**) 
 **/
 
+#ifdef USE_STACK_CACHE
+		case PUSH:    s = f; f = m[ck(I++)]; cached = CACHED_STATE; break;
+		case CONST:   s = f; f = m[ck(pc)];  cached = CACHED_STATE; break;
+#else
 		case PUSH:    *++S = f;     f = m[ck(I++)];          break;
 		case CONST:   *++S = f;     f = m[ck(pc)];           break;
-		case RUN:     m[ck(++m[RSTK])] = I; I = pc;          break;
+#endif
+		case RUN:
+			POLL();
+			RCHECK(1);
+			m[ck(++m[RSTK])] = I;
+			I = pc;
+			if (o->native_count) {
+				forth_native_t native = forth_native_find(o, pc);
+				if (native) {
+					struct forth_native_state st = {
+						.m = m, .S = S, .f = f, .I = I,
+						.vstart = o->vstart, .vend = o->vend,
+						.size = o->core_size,
+						.fault = &o->fault, .fuel = fuel,
+#if TRACE_RING_SIZE
+						.ring = o->trace_ring,
+						.ring_mask = TRACE_RING_SIZE - 1,
+						.ring_next = tn,
+#endif
+					};
+					native(&st);
+					S = st.S;
+					f = st.f;
+					I = st.I;
+					fuel = st.fuel;
+#if TRACE_RING_SIZE
+					tn = st.ring_next;
+#endif
+				}
+			}
+			break;
 /**
 **DEFINE** backs the Forth word **:**, which is an immediate word, it reads in a
 new word name, creates a header for that word and enters into compile mode,
@@ -2288,19 +6517,19 @@ instead of being executed.
 
 The created header looks like this:
 
-	 .------.-----.------.----
-	 | NAME | PWD | CODE |    ...
-	 .------.-----.------.----
-	                        ^
-	                        |
-	                   Dictionary Pointer 
+	 .--------.-----.------.-----.------.----
+	 | THREAD | KEY | NAME | PWD | CODE |    ...
+	 .--------.-----.------.-----.------.----
+	                                       ^
+	                                       |
+	                                  Dictionary Pointer 
 
 The CODE field contains the RUN instruction.
 **/
 		case DEFINE:
 			m[STATE] = 1; /* compile mode */
 			if (forth_get_word(o, o->s, MAXIMUM_WORD_LENGTH) < 0)
-				goto end;
+				goto input_end;
 			compile(o, RUN, (char*)o->s, true, false);
 			break;
 /**
@@ -2350,22 +6579,62 @@ recursively).
 
 **/
 			if (forth_get_word(o, o->s, MAXIMUM_WORD_LENGTH) < 0)
-				goto end;
+				goto input_end;
 			if ((w = forth_find(o, (char*)o->s)) > 1) {
 				pc = w;
 				if (m[STATE] && (m[ck(pc)] & COMPILING_BIT)) {
 					m[dic(m[DIC]++)] = pc; /* compile word */
+					if (o->fault)
+						goto on_fault;
 					break;
 				}
+				o->read_xt = pc; /* for the profiler */
 				goto INNER; /* execute word */
 			} else if (forth_string_to_cell(o->m[BASE], &w, (char*)o->s)) {
-				error("'%s' is not a word (line %zu)", o->s, o->line);
-				longjmp(on_error, RECOVERABLE);
+				double r;
+				forth_cell_t hi;
+				if (!forth_string_to_double(o->m[BASE], &w, &hi, (char*)o->s)) {
+					if (m[STATE]) { /* compile two literals */
+						m[dic(m[DIC]++)] = 2;
+						m[dic(m[DIC]++)] = w;
+						m[dic(m[DIC]++)] = 2;
+						m[dic(m[DIC]++)] = hi;
+						if (o->fault)
+							goto on_fault;
+					} else {
+						*++S = f;
+						*++S = w;
+						f = hi;
+					}
+					break;
+				}
+				if ((m[BASE] != 10 && m[BASE] != 0) || 
+					forth_string_to_float(&r, (char*)o->s, strlen((char*)o->s), true)) {
+					error("'%s' is not a word (line %zu)", o->s, o->line);
+					o->fault = THROW_UNDEFINED_WORD;
+					goto on_fault;
+				}
+				if (m[STATE]) { /* compile a floating point literal */
+					(void)dic(m[DIC] + FLOAT_CELLS);
+					if (o->fault)
+						goto on_fault;
+					m[m[DIC]++] = m[FLITERAL];
+					forth_float_save(m, m[DIC], r);
+					m[DIC] += FLOAT_CELLS;
+				} else if (m[FLOAT_DEPTH] >= FLOAT_STACK_SIZE) {
+					o->fault = THROW_FLOAT_OVERFLOW;
+					goto on_fault;
+				} else {
+					forth_float_save(m, m[FLOAT_STACK] + m[FLOAT_DEPTH]++ * FLOAT_CELLS, r);
+				}
+				break;
 			}
 
 			if (m[STATE]) { /* must be a number then */
 				m[dic(m[DIC]++)] = 2; /*fake word push at m[2] */
 				m[dic(m[DIC]++)] = w;
+				if (o->fault)
+					goto on_fault;
 			} else { /* push word */
 				*++S = f;
 				f = w;
@@ -2399,25 +6668,46 @@ require some explaining, but ADD, SUB and DIV will not.
 				f = *S-- / f;
 			} else {
 				error("divide %"PRIdCell" by zero ", *S--);
-				longjmp(on_error, RECOVERABLE);
+				o->fault = THROW_DIVISION_BY_ZERO;
+				goto on_fault;
 			} 
 			break;
 		case ULESS:   f = *S-- < f;                     break;
 		case UMORE:   f = *S-- > f;                     break;
 		case EXIT:    I = m[ck(m[RSTK]--)];             break;
-		case KEY:     *++S = f; f = forth_get_char(o);  break;
+		case KEY:
+			if (!forth_input_ready(o, false))
+				goto input_wait;
+			*++S = f; 
+			f = forth_get_char(o);
+			break;
 		case EMIT:    f = fputc(f, (FILE*)o->m[FOUT]);  break;
+#ifdef USE_STACK_CACHE
+		case FROMR:   s = f; f = m[ck(m[RSTK]--)]; cached = CACHED_STATE; break;
+#else
 		case FROMR:   *++S = f; f = m[ck(m[RSTK]--)];   break;
-		case TOR:     m[ck(++m[RSTK])] = f; f = *S--;   break;
-		case BRANCH:  I += m[ck(I)];                    break;
-		case QBRANCH: I += f == 0 ? m[I] : 1; f = *S--; break;
+#endif
+		case TOR:     RCHECK(1); m[ck(++m[RSTK])] = f; f = *S--; break;
+		case BRANCH:  POLL(); I += m[ck(I)];            break;
+		case QBRANCH: POLL(); I += f == 0 ? m[I] : 1; f = *S--; break;
 		case PNUM:    f = print_cell(o, (FILE*)(o->m[FOUT]), f); break;
-		case COMMA:   m[dic(m[DIC]++)] = f; f = *S--;   break;
+		case COMMA:   
+			m[dic(m[DIC]++)] = f; 
+			f = *S--;
+			if (o->fault)
+				goto on_fault;
+			break;
 		case EQUAL:   f = *S-- == f;                    break;
+#ifdef USE_STACK_CACHE
+		case SWAP:    s = f; f = *S--; cached = CACHED_STATE; break;
+		case DUP:     s = f;           cached = CACHED_STATE; break;
+		case OVER:    s = f; f = *S;   cached = CACHED_STATE; break;
+#else
 		case SWAP:    w = f;  f = *S--;   *++S = w;     break;
 		case DUP:     *++S = f;                         break;
-		case DROP:    f = *S--;                         break;
 		case OVER:    w = *S; *++S = f; f = w;          break;
+#endif
+		case DROP:    f = *S--;                         break;
 /**
 **TAIL** is a crude method of doing tail recursion, it should not be used 
 generally but is useful at startup, there are limitations when using it 
@@ -2453,9 +6743,9 @@ it already exits, it looks up a Forth word in the dictionary and returns a
 pointer to that word if it found.
 **/
 		case FIND:
-			*++S = f;
 			if (forth_get_word(o, o->s, MAXIMUM_WORD_LENGTH) < 0)
-				goto end;
+				goto input_end;
+			*++S = f;
 			f = forth_find(o, (char*)o->s);
 			f = f < DICTIONARY_START ? 0 : f;
 			break;
@@ -2492,7 +6782,8 @@ of the stack.
 /**
 CLOCK allows for a primitive and wasteful (depending on how the C
 library implements "clock") timing mechanism, it has the advantage of being
-portable:
+portable. For timing anything short **NS** and **CYCLES** should be used
+instead, see *forth_nanoseconds*.
 **/
 		case CLOCK:
 			*++S = f;
@@ -2500,22 +6791,18 @@ portable:
 			break;
 /**
 EVALUATOR is another complex word which needs to be implemented in
-the virtual machine. It saves and restores state which we do
-not usually need to do when the interpreter is not running (the usual case
-for **forth_eval** when called from C). It can read either from a string
-or from a file.
+the virtual machine. It saves the current input in a frame on the return
+stack, described in **evaluate_pop**, and switches to reading input either
+from a string or from a file. When that input runs out the frame is removed
+again, see *input_end*.
 **/
 		case EVALUATOR:
 		{ 
-			/* save current input */
-			forth_cell_t sin    = o->m[SIN],  sidx = o->m[SIDX],
-				slen   = o->m[SLEN], fin  = o->m[FIN],
-				source = o->m[SOURCE_ID], r = m[RSTK];
 			char *s = NULL;
 			FILE *file = NULL;
-			forth_cell_t length;
-			int file_in = 0;
-			file_in = f; /*get file/string in bool*/
+			forth_cell_t length = 0;
+			int file_in = f; /*get file/string in bool*/
+			RCHECK(8);
 			f = *S--;
 			if (file_in) {
 				file = (FILE*)(*S--);
@@ -2525,36 +6812,40 @@ or from a file.
 				length = f;
 				f = *S--;
 			}
-			/* save the stack variables */
-			o->S = S;
-			o->m[TOP] = f;
-			/* push a fake call to forth_eval */
-			m[RSTK]++;
-			if (file_in) {
+			m[ck(++m[RSTK])] = I;
+			m[ck(++m[RSTK])] = m[SOURCE_ID];
+			m[ck(++m[RSTK])] = m[SIN];
+			m[ck(++m[RSTK])] = m[SIDX];
+			m[ck(++m[RSTK])] = m[SLEN];
+			m[ck(++m[RSTK])] = m[FIN];
+			m[ck(++m[RSTK])] = m[EVAL_FRAME];
+			m[EVAL_FRAME] = m[RSTK];
+			m[ck(++m[RSTK])] = 0;
+			if (file_in)
 				forth_set_file_input(o, file);
-				w = forth_run(o);
-			} else {
-				w = forth_eval_block(o, s, length);
-			}
-			/* restore stack variables */
-			m[RSTK] = r;
-			S = o->S;
-			*++S = o->m[TOP];
-			f = w;
-			/* restore input stream */
-			o->m[SIN]  = sin;
-			o->m[SIDX] = sidx;
-			o->m[SLEN] = slen;
-			o->m[FIN]  = fin;
-			o->m[SOURCE_ID] = source;
-			if (forth_is_invalid(o))
-				return -1;
+			else
+				forth_set_block_input(o, s, length);
+			I = m[INSTRUCTION];
 			break;
 		}
 		case PSTK:    print_stack(o, (FILE*)(o->m[STDOUT]), S, f);
 			      fputc('\n', (FILE*)(o->m[STDOUT]));
 			      break;
-		case RESTART: longjmp(on_error, f);                   break;
+		case RECENT:  TRACE_SYNC();
+			      forth_trace_dump(o, (FILE*)(o->m[STDOUT]));
+			      break;
+		case RESTART:
+			w = f;
+			f = *S--;
+			if (w == OK)
+				goto warm;
+			if (w == RECOVERABLE) {
+				TRACE_SYNC();
+				forth_trace_dump(o, (FILE*)(o->m[STDERR]));
+				goto on_error;
+			}
+			forth_invalidate(o);
+			goto invalid;
 
 /**
 CALL allows arbitrary C functions to be passed in and used within
@@ -2583,6 +6874,8 @@ and executes the function.
 			assert(o->calls->functions[i].function);
 			/* check depth of function */
 			cd(o->calls->functions[i].depth);
+			if (o->fault)
+				goto on_fault;
 			/* pop call number */
 			f = *S--; 
 			/* save stack state */
@@ -2609,15 +6902,27 @@ written to. This would allow the KEY to be removed as a virtual machine
 instruction, and would be a useful abstraction. 
 **/
 
-		case SYSTEM:  f = system(forth_get_string(o, &on_error, &S, f)); break;
+		case SYSTEM:  
+		{
+			char *s = forth_get_string(o, &S, f);
+			if (!s)
+				goto on_fault;
+			f = system(s);
+			break;
+		}
 		case FCLOSE:  
 			      errno = 0;
 			      f = fclose((FILE*)f) ? ferrno() : 0;       
 			      break;
 		case FDELETE: 
-			      errno = 0;
-			      f = remove(forth_get_string(o, &on_error, &S, f)) ? ferrno() : 0; 
-			      break;
+		{
+			char *s = forth_get_string(o, &S, f);
+			if (!s)
+				goto on_fault;
+			errno = 0;
+			f = remove(s) ? ferrno() : 0; 
+			break;
+		}
 		case FFLUSH:  
 			      errno = 0; 
 			      f = fflush((FILE*)f) ? ferrno() : 0;       
@@ -2639,9 +6944,11 @@ instruction, and would be a useful abstraction.
 			}
 		case FOPEN: 
 			{
-				const char *fam = forth_get_fam(&on_error, f);
+				const char *fam = forth_get_fam(o, f);
 				f = *S--;
-				char *file = forth_get_string(o, &on_error, &S, f);
+				char *file = forth_get_string(o, &S, f);
+				if (!fam || !file)
+					goto on_fault;
 				errno = 0;
 				*++S = (forth_cell_t)fopen(file, fam);
 				f = ferrno();
@@ -2669,9 +6976,11 @@ instruction, and would be a useful abstraction.
 			break;
 		case FRENAME:  
 			{
-				const char *f1 = forth_get_fam(&on_error, f);
+				const char *f1 = forth_get_fam(o, f);
 				f = *S--;
-				char *f2 = forth_get_string(o, &on_error, &S, f);
+				char *f2 = forth_get_string(o, &S, f);
+				if (!f1 || !f2)
+					goto on_fault;
 				errno = 0;
 				f = rename(f2, f1) ? ferrno() : 0;
 			}
@@ -2729,6 +7038,28 @@ to interact with memory outside of the Forth core.
 			w = *S--;
 			f = memcmp((char*)(*S--), (char*)w, f);
 			break;
+		case MEMMEM:
+			w = *S--;
+			S -= 2;
+			f = (forth_cell_t)forth_memory_search((char*)S[1], S[2], (char*)w, f);
+			break;
+		case MEMICMP:
+			w = *S--;
+			f = forth_memory_icompare((unsigned char*)(*S--), (unsigned char*)w, f);
+			break;
+		case MEMCOUNT:
+			w = *S--;
+			f = forth_memory_count((unsigned char*)(*S--), w, f);
+			break;
+		case MEMSETC:
+			w = *S--;
+			forth_cells_set((forth_cell_t*)(*S--), w, f);
+			f = *S--;
+			break;
+		case MEMCHRC:
+			w = *S--;
+			f = (forth_cell_t)forth_cells_locate((forth_cell_t*)(*S--), w, f);
+			break;
 		case ALLOCATE:
 			errno = 0;
 			*++S = (forth_cell_t)calloc(f, 1);
@@ -2753,35 +7084,725 @@ requires that an error status is returned.
 			break;
 		case GETENV:
 		{
-			char *s = getenv(forth_get_string(o, &on_error, &S, f));
+			char *s = forth_get_string(o, &S, f);
+			if (!s)
+				goto on_fault;
+			s = getenv(s);
 			f = s ? strlen(s) : 0;
 			*++S = (forth_cell_t)s;
 			break;
 		}
+/**
+**CATCH** pushes an exception frame onto the return stack and then executes 
+the execution token on the top of the variable stack. The frame holds what 
+is needed to return to the caller of **catch**, with the variable stack 
+restored, if an exception is thrown, and **THROW_HANDLER** points to the 
+last cell of the innermost frame:
+
+	.----------------.---------------.-----------.------------------.
+	| Return Address | Stack Pointer | Top Value | Previous Handler |
+	.----------------.---------------.-----------.------------------.
+	                                                      ^
+	                                                      |
+	                                              m[THROW_HANDLER]
+
+The word is executed with the instruction pointer set to **CATCH_EXIT**, so 
+that when it returns normally **UNCATCH** is executed next, which removes 
+the frame and pushes zero. **THROW** with a non zero value does the same 
+thing as a check failing within the virtual machine, the frame is unwound 
+by the code at *on_fault*.
+**/
+		case CATCH:
+			RCHECK(4);
+			w = f;
+			f = *S--;
+			m[ck(++m[RSTK])] = I;
+			m[ck(++m[RSTK])] = S - m;
+			m[ck(++m[RSTK])] = f;
+			m[ck(++m[RSTK])] = m[THROW_HANDLER];
+			m[THROW_HANDLER] = m[RSTK];
+			I = CATCH_EXIT;
+			pc = w;
+			goto INNER;
+		case THROW:
+			w = f;
+			f = *S--;
+			if (!w)
+				break;
+			o->fault = w;
+			goto on_fault;
+		case UNCATCH:
+			w = m[RSTK];
+			m[THROW_HANDLER] = m[ck(w)];
+			I = m[ck(w - 3)];
+			m[RSTK] = w - 4;
+			*++S = f;
+			f = 0;
+			break;
+/**
+**PAUSE** switches to the next task that is awake, and **STOP** puts the
+current task to sleep before doing the same, see *task_next*. The 
+interpreter task cannot be stopped. **ACTIVATE** sets up the task control 
+block of a task, created by **task** in *forth.fth*, so that it executes an 
+execution token when it is next switched to, adding it to the list of tasks
+if it is not already in it. When the execution token returns the task
+executes **STOP**.
+**/
+		case PAUSE:
+			if (!(w = m[TASK]))
+				break;
+			goto task_next;
+		case STOP:
+			if (!(w = m[TASK]) || w == m[MAIN_TASK])
+				break;
+			m[w + TASK_STATUS] = 0;
+			goto task_next;
+		case ACTIVATE:
+			w = f;
+			pc = *S--;
+			f = *S--;
+			if (!m[TASK] || w == m[TASK] || w == m[MAIN_TASK]) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			m[ck(w + TASK_SIZE - 1)] = 0;
+			m[w + TASK_VSTART]  = w + TASK_USER + TASK_USER_SIZE;
+			m[w + TASK_VEND]    = m[w + TASK_VSTART] + TASK_STACK_SIZE;
+			m[w + TASK_RSTART]  = m[w + TASK_VEND];
+			m[w + TASK_REND]    = m[w + TASK_RSTART] + TASK_STACK_SIZE - RSTK_SPARE;
+			m[w + TASK_S]       = m[w + TASK_VSTART];
+			m[w + TASK_TOP]     = 0;
+			m[w + TASK_RSTK]    = m[w + TASK_RSTART];
+			m[w + TASK_HANDLER] = 0;
+			m[w + TASK_EVAL]    = 0;
+			m[w + TASK_ENTRY]   = pc;
+			m[w + TASK_EXIT]    = w + TASK_STOP;
+			m[w + TASK_STOP]    = STOP;
+			m[w + TASK_I]       = w + TASK_ENTRY;
+			if (!m[w + TASK_LINK]) {
+				m[w + TASK_LINK] = m[m[TASK] + TASK_LINK];
+				m[m[TASK] + TASK_LINK] = w;
+			}
+			m[w + TASK_STATUS] = 1;
+			break;
+		case NS:     *++S = f; f = forth_nanoseconds(); break;
+		case CYCLES: *++S = f; f = forth_cycles();      break;
+		case TONUMBER:
+			if (ckcharrange(*S, f))
+				goto on_fault;
+			w = forth_digits(m[BASE] ? m[BASE] : 10, S - 1, 
+					((char*)m) + ckchar(*S), f);
+			*S += w;
+			f  -= w;
+			break;
+		case PCELLS:
+		{
+			int pending = 0;
+			forth_cell_t count = 0, max = *S--, addr = *S--;
+			if (ckrange(addr, max) || ckcharrange(S[-1], *S))
+				goto on_fault;
+			w = forth_parse_cells(m[BASE], ((char*)m) + ckchar(S[-1]), *S, 
+					m + ck(addr), &count, max, f, &pending);
+			S[-1] += w;
+			*S    -= w;
+			f      = count;
+			break;
+		}
+		case FCELLS:
+		{
+			FILE *file = (FILE*)f;
+			forth_cell_t count = 0, sep = *S--, max = *S--;
+			if (ckrange(*S, max))
+				goto on_fault;
+			f  = forth_read_cells(m[BASE], file, m + ck(*S), &count, max, sep);
+			*S = count;
+			break;
+		}
+/**
+The vector instructions check the operation they are given and that the
+arrays fit in the core before any of them are touched, they do nothing for
+an empty array.
+**/
+		case VMAP:
+		case VSCALAR:
+		{
+			forth_cell_t n = *S--, c = *S--, b = *S--, a = *S--;
+			if (f >= LAST_VECTOR_OPERATION) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			if (ckrange(a, n) || ckrange(b, n) || (w == VMAP && ckrange(c, n)))
+				goto on_fault;
+			if (w == VMAP)
+				forth_vector_map(m + ck(a), m + ck(b), m + ck(c), 1, n, f);
+			else
+				forth_vector_map(m + ck(a), m + ck(b), &c, 0, n, f);
+			f = *S--;
+			break;
+		}
+		case VREDUCE:
+			w = *S--;
+			if (f >= LAST_VECTOR_OPERATION) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			if (ckrange(*S, w))
+				goto on_fault;
+			f = forth_vector_reduce(m + ck(*S--), w, f);
+			break;
+		case VSCAN:
+		{
+			forth_cell_t n = *S--, b = *S--, a = *S--;
+			if (f >= LAST_VECTOR_OPERATION) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			if (ckrange(a, n) || ckrange(b, n))
+				goto on_fault;
+			forth_vector_scan(m + ck(a), m + ck(b), n, f);
+			f = *S--;
+			break;
+		}
+		case VDOT:
+			w = *S--;
+			if (ckrange(w, f) || ckrange(*S, f))
+				goto on_fault;
+			f = forth_vector_dot(m + ck(*S--), m + ck(w), f);
+			break;
+/**
+Only the sign bit differs between sorting signed and unsigned numbers,
+see **forth_sort_cells**. **SORTSTEP** is used in a loop by *sort-by* in
+*forth.fth*, which executes the comparison **forth_sort_step** asks for
+each time around the loop, it leaves a zero on the stack in place of its
+state when the sort is done.
+**/
+		case SORT:
+		case SORTKV:
+			w = w == SORTKV ? 2 : 1;
+			if (ckrange(S[-1], *S) || ckrange(S[-1], *S * w)) 
+				goto on_fault; /* the first stops the second overflowing */
+			forth_sort_cells(m + ck(S[-1]), *S, w, f ? SIGN_BIT : 0);
+			S -= 2;
+			f = *S--;
+			break;
+		case BSEARCH:
+		{
+			forth_cell_t x = *S--, n = *S--, a = *S;
+			if (ckrange(a, n))
+				goto on_fault;
+			w = forth_search_cells(m + ck(a), n, x, f ? SIGN_BIT : 0);
+			*S = w;
+			f = w < n && m[a + w] == x;
+			break;
+		}
+		case SORTSTEP:
+		{
+			forth_cell_t i = 0, j = 0, *s = S - (SORT_STATE_SIZE - 1), a = s[-1];
+			if (ckrange(a, s[SORT_END]))
+				goto on_fault;
+			if (!forth_sort_valid(s)) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			if (forth_sort_step(m + ck(a), s, f, &i, &j)) {
+				*++S = m[a + i];
+				*++S = m[a + j];
+				f = 1;
+			} else {
+				S -= SORT_STATE_SIZE + 1;
+				f = 0;
+			}
+			break;
+		}
+		case CRC32C:
+		case CRC16:
+			if (ckcharrange(*S, f))
+				goto on_fault;
+			if (w == CRC16)
+				w = forth_crc16(S[-1], (char*)m + ckchar(*S), f);
+			else
+				w = forth_crc32c(S[-1], (char*)m + ckchar(*S), f);
+			S -= 2;
+			f = w;
+			break;
+/**
+The hash map instructions take a key as a cell and a length, which is
+**MAP_CELL_KEY**, or -1, for keys that are cells and not strings.
+**/
+		case MAPFIND:
+		case MAPSTORE:
+		case MAPDELETE:
+		{
+			forth_cell_t *map = check_map(o, f), len = *S--, key = *S--, *s;
+			if (!map)
+				goto on_fault;
+			if (len != MAP_CELL_KEY && ckcharrange(key, len))
+				goto on_fault;
+			if (w == MAPFIND) {
+				s = forth_map_find((char*)m, map, key, len);
+				*++S = s ? s[SLOT_VALUE] : 0;
+				f = s != NULL;
+			} else if (w == MAPSTORE) {
+				f = forth_map_store((char*)m, map, key, len, *S--);
+			} else {
+				f = forth_map_delete((char*)m, map, key, len);
+			}
+			break;
+		}
+		case MAPNEXT:
+		{
+			forth_cell_t *map = check_map(o, f);
+			if (!map)
+				goto on_fault;
+			f = forth_map_next(map, *S--);
+			break;
+		}
+/**
+**SEARCHWORDLIST** copies the name it is given so it is terminated by a NUL,
+like the names in the dictionary, and then searches one wordlist for it.
+**/
+		case SEARCHWORDLIST:
+		{
+			char name[MAXIMUM_WORD_LENGTH];
+			forth_cell_t wid = f, len = *S--, addr = *S--;
+			if (wid > o->core_size - WORDLIST_SIZE) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			f = 0;
+			if (!len || len >= MAXIMUM_WORD_LENGTH)
+				break;
+			(void)ckchar(addr + len - 1);
+			if (o->fault)
+				goto on_fault;
+			memcpy(name, (char*)m + addr, len);
+			name[len] = '\0';
+			if ((w = forth_find_wordlist(o, wid, name, forth_name_key(name)))) {
+				*++S = w + 1;
+				f = m[w + 1] & COMPILING_BIT ? (forth_cell_t)-1 : 1;
+			}
+			break;
+		}
+/**
+The double cell words keep the most significant cell of a double cell
+number on top of the stack, the work is done by the functions in the
+section on double cell arithmetic.
+**/
+		case UMSTAR:
+			*S = forth_umul(*S, f, &f);
+			break;
+		case MSTAR:
+			*S = forth_mul(*S, f, &f);
+			break;
+		case UMSLMOD:
+			if (!f || S[0] >= f) {
+				o->fault = f ? THROW_RESULT_OUT_OF_RANGE : THROW_DIVISION_BY_ZERO;
+				goto on_fault;
+			}
+			S[-1] = forth_umdiv(S[-1], S[0], f, &f);
+			S--;
+			break;
+		case SMSLREM:
+		case FMSLMOD:
+			if ((o->fault = forth_smdiv(S[-1], S[0], f, w == FMSLMOD, &S[-1], &f)))
+				goto on_fault;
+			S--;
+			break;
+		case DPLUS:
+			w = S[-2] + S[0];
+			f = S[-1] + f + (w < S[-2]);
+			S -= 2;
+			*S = w;
+			break;
+		case DMINUS:
+			w = S[-2] - S[0];
+			f = S[-1] - f - (S[-2] < S[0]);
+			S -= 2;
+			*S = w;
+			break;
+		case DNEGATE:
+			*S = -*S;
+			f = ~f + !*S;
+			break;
+		case DLESS:
+			w = S[-1] != f ? (S[-1] ^ SIGN_BIT) < (f ^ SIGN_BIT) : S[-2] < S[0];
+			S -= 3;
+			f = w;
+			break;
+/**
+**FLOAT** does the work for all of the floating point words, which have
+the operation to perform in their body. The numbers an operation uses
+are taken off the floating point stack into **r**, deepest first, and
+the results it leaves in **r** are put back afterwards.
+**/
+		case FLOAT:
+		{
+			forth_cell_t op = m[ck(pc)], n = m[FLOAT_DEPTH], out;
+			double r[3], t;
+			if (op >= LAST_FLOAT_OPERATION) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			cd(float_bounds[op].depth);
+			if (n < float_bounds[op].in || n > FLOAT_STACK_SIZE)
+				o->fault = THROW_FLOAT_UNDERFLOW;
+			else if (n - float_bounds[op].in + float_bounds[op].out > FLOAT_STACK_SIZE)
+				o->fault = THROW_FLOAT_OVERFLOW;
+			if (o->fault)
+				goto on_fault;
+			n -= float_bounds[op].in;
+			out = float_bounds[op].out;
+			for (w = 0; w < float_bounds[op].in; w++)
+				r[w] = forth_float_load(m, m[FLOAT_STACK] + (n + w) * FLOAT_CELLS);
+			switch (op) {
+			case FLIT:
+				(void)ck(I + FLOAT_CELLS - 1);
+				if (o->fault)
+					goto on_fault;
+				r[0] = forth_float_load(m, I);
+				I += FLOAT_CELLS;
+				break;
+			case FSTORE:
+			case FFETCH:
+				(void)ck(f + FLOAT_CELLS - 1);
+				if (o->fault)
+					goto on_fault;
+				if (op == FSTORE)
+					forth_float_save(m, f, r[0]);
+				else
+					r[0] = forth_float_load(m, f);
+				f = *S--;
+				break;
+			case FDEPTH:  *++S = f; f = n; break;
+			case FDROP:   break;
+			case FDUP:    r[1] = r[0]; break;
+			case FSWAP:   t = r[0]; r[0] = r[1]; r[1] = t; break;
+			case FOVER:   r[2] = r[0]; break;
+			case FROT:    t = r[0]; r[0] = r[1]; r[1] = r[2]; r[2] = t; break;
+			case FPLUS:   r[0] += r[1]; break;
+			case FMINUS:  r[0] -= r[1]; break;
+			case FSTAR:   r[0] *= r[1]; break;
+			case FSLASH:  r[0] /= r[1]; break;
+			case FPOWER:  r[0] = pow(r[0], r[1]); break;
+			case FMAX:    r[0] = fmax(r[0], r[1]); break;
+			case FMIN:    r[0] = fmin(r[0], r[1]); break;
+			case FATAN2:  r[0] = atan2(r[0], r[1]); break;
+			case FNEGATE: r[0] = -r[0]; break;
+			case FABS:    r[0] = fabs(r[0]); break;
+			case FSQRT:   r[0] = sqrt(r[0]); break;
+			case FSIN:    r[0] = sin(r[0]); break;
+			case FCOS:    r[0] = cos(r[0]); break;
+			case FTAN:    r[0] = tan(r[0]); break;
+			case FATAN:   r[0] = atan(r[0]); break;
+			case FEXP:    r[0] = exp(r[0]); break;
+			case FLN:     r[0] = log(r[0]); break;
+			case FLOOR:   r[0] = floor(r[0]); break;
+			case FROUND:  r[0] = nearbyint(r[0]); break;
+			case FTRUNC:  r[0] = trunc(r[0]); break;
+			case FZLESS:  *++S = f; f = r[0] < 0; break;
+			case FZEQUAL: *++S = f; f = r[0] == 0; break;
+			case FLESS:   *++S = f; f = r[0] < r[1]; break;
+			case STOF:    r[0] = (intptr_t)f; f = *S--; break;
+			case FTOS:    *++S = f; f = (forth_cell_t)(intptr_t)r[0]; break;
+			case DTOF:
+				r[0] = ldexp((double)(intptr_t)f, CELL_BITS) + (double)*S--;
+				f = *S--;
+				break;
+			case FTOD:
+				*++S = f;
+				*++S = forth_float_to_double_cell(r[0], &f);
+				break;
+			case TOFLOAT:
+				if (ckcharrange(*S, f))
+					goto on_fault;
+				out = !forth_string_to_float(&r[0], (char*)m + *S, f, false);
+				S--;
+				f = out; /* a number is only pushed if there is one */
+				break;
+			case FDOT:
+			case FSDOT:
+				forth_float_print((FILE*)(o->m[FOUT]), r[0], (int)m[PRECISION], op == FSDOT);
+				break;
+			case FLOATS:    f *= FLOAT_CELLS; break;
+			case FLOATPLUS: f += FLOAT_CELLS; break;
+			}
+			for (w = 0; w < out; w++)
+				forth_float_save(m, m[FLOAT_STACK] + (n + w) * FLOAT_CELLS, r[w]);
+			m[FLOAT_DEPTH] = n + out;
+			break;
+		}
+/**
+**BIGNUM** gathers up the arguments of a bignum operation, deepest first,
+and hands them to **forth_bignum**.
+**/
+		case BIGNUM:
+		{
+			forth_cell_t op = m[ck(pc)], args[4], result = 0;
+			if (op >= LAST_BIGNUM_OPERATION) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			cd(bignum_bounds[op].depth);
+			if (o->fault)
+				goto on_fault;
+			for (w = bignum_bounds[op].depth; w--;) {
+				args[w] = f;
+				f = *S--;
+			}
+			if ((o->fault = forth_bignum(o, op, args, &result)))
+				goto on_fault;
+			if (bignum_bounds[op].out) {
+				*++S = f;
+				f = result;
+			}
+			break;
+		}
+/**
+**REGEX** does the same for the regular expression words, which can give
+back more than one cell.
+**/
+		case REGEX:
+		{
+			forth_cell_t op = m[ck(pc)], args[4], results[3] = { 0 };
+			if (op >= LAST_REGEX_OPERATION) {
+				o->fault = THROW_INVALID_ARGUMENT;
+				goto on_fault;
+			}
+			cd(regex_bounds[op].depth);
+			if (o->fault)
+				goto on_fault;
+			for (w = regex_bounds[op].depth; w--;) {
+				args[w] = f;
+				f = *S--;
+			}
+			if ((o->fault = forth_regex(o, op, args, results)))
+				goto on_fault;
+			for (w = 0; w < regex_bounds[op].out; w++) {
+				*++S = f;
+				f = results[w];
+			}
+			break;
+		}
 		case BYE:
-			rval = f;
+			w = f;
 			f = *S--;
+			if (m[EVAL_FRAME] != e)
+				goto evaluate_end;
+			rval = w;
 			goto end;
 /**
 This should never happen, and if it does it is an indication that virtual
 machine memory has been corrupted somehow.
 **/
 		default:
+#ifdef USE_STACK_CACHE
+			if (cached) { /* spill, then handle in the first state */
+				*++S = s;
+				cached = 0;
+				goto REDISPATCH;
+			}
+#endif
 			fatal("illegal operation %" PRIdCell, w);
-			longjmp(on_error, FATAL);
+			forth_invalidate(o);
+			goto invalid;
 		}
 	}
+	if (o->fault)
+		goto on_fault;
 /**
 We must save the stack pointer and the top of stack when we exit the
 interpreter so the C functions like "forth_pop" work correctly. If the
 **forth_t** object has been invalidated (because something went wrong),
 we do not have to jump to *end* as functions like **forth_pop** should not
-be called on the invalidated object any longer.
+be called on the invalidated object any longer. The loop above can finish
+in either state of the stack cache, so **s** is spilled here.
 **/
 end:	
+#ifdef USE_STACK_CACHE
+	if (cached) {
+		*++S = s;
+		cached = 0;
+	}
+#endif
+	TRACE_SYNC();
 	o->S = S;
 	o->m[TOP] = f;
 	return rval;
+invalid:
+	TRACE_SYNC();
+	forth_trace_dump(o, (FILE*)(o->m[STDERR]));
+	return -1;
+
+/**
+When the input runs out the virtual machine returns to its caller, unless
+the input being read was passed to **EVALUATOR** in this call to
+**forth_run**, in which case the previous input is restored and execution
+continues after the word that called **EVALUATOR**, with the value in 
+**w** pushed onto the stack (this is normally zero, or the value passed
+to **BYE**).
+**/
+input_end:
+	if (m[SOURCE_ID] == (forth_cell_t)FEED_IN)
+		goto input_wait;
+	if (m[EVAL_FRAME] == e) {
+		w = m[TASK];
+		if (!w || w != m[MAIN_TASK] || m[w + TASK_LINK] == w)
+			goto end;
+		m[w + TASK_STATUS] = 0; /* run the other tasks first */
+		goto task_next;
+	}
+	w = 0;
+evaluate_end:
+	I = evaluate_pop(o);
+	*++S = f;
+	f = w;
+	goto run;
+
+/**
+Input from **forth_feed** has not ended when it runs out, so the virtual
+machine returns to its caller to get some more. It does the same when it
+runs out of **fuel**, but only if a budget was set, otherwise the tank is
+refilled and the instruction carries on.
+
+When suspending, the instruction pointer and the evaluate frame that
+this call started with are saved on the return stack. The code field of
+the instruction that stopped, which has not done anything yet, is saved
+in the **RESUME** register, so the next call to **forth_run** can
+execute it again.
+**/
+poll:
+	if (o->fault)
+		goto on_fault;
+	if (!o->budget) {
+		fuel = (forth_cell_t)-1;
+		pc--;
+		goto INNER;
+	}
+	o->status = FORTH_STATUS_BUDGET;
+	goto suspend;
+input_wait:
+	o->status = FORTH_STATUS_NEEDS_INPUT;
+suspend:
+#ifdef USE_STACK_CACHE
+	if (cached) {
+		*++S = s;
+		cached = 0;
+	}
+#endif
+	m[ck(++m[RSTK])] = e;
+	m[ck(++m[RSTK])] = I;
+	m[RESUME] = pc - 1;
+	goto end;
+
+/**
+*task_next* saves the state of the current task, whose control block is in
+**w**, and switches to the next task in the list that is awake. If there
+is none then the interpreter task is switched to, and if that is asleep 
+it is because its input has run out, so it is woken up and the virtual
+machine returns. A task that has stopped is taken out of the list, so
+only the interpreter task can be asleep in it, and the memory of a 
+stopped task can be reused or forgotten.
+**/
+task_next:
+	m[w + TASK_S]       = S - m;
+	m[w + TASK_TOP]     = f;
+	m[w + TASK_I]       = I;
+	m[w + TASK_RSTK]    = m[RSTK];
+	m[w + TASK_HANDLER] = m[THROW_HANDLER];
+	m[w + TASK_EVAL]    = m[EVAL_FRAME];
+	if (!m[w + TASK_STATUS] && w != m[MAIN_TASK]) {
+		for (pc = w; m[ck(pc + TASK_LINK)] != w;)
+			pc = m[pc + TASK_LINK];
+		m[pc + TASK_LINK] = m[w + TASK_LINK];
+		m[w + TASK_LINK]  = 0;
+		w = pc;
+	}
+	for (pc = m[w + TASK_LINK]; pc != w && !m[pc + TASK_STATUS];)
+		pc = m[ck(pc + TASK_LINK)];
+	if (!m[pc + TASK_STATUS])
+		pc = m[MAIN_TASK];
+	m[TASK]          = pc;
+	S                = m + m[pc + TASK_S];
+	f                = m[pc + TASK_TOP];
+	I                = m[pc + TASK_I];
+	m[RSTK]          = m[pc + TASK_RSTK];
+	m[THROW_HANDLER] = m[pc + TASK_HANDLER];
+	m[EVAL_FRAME]    = m[pc + TASK_EVAL];
+	o->vstart        = m + m[pc + TASK_VSTART];
+	o->vend          = m + m[pc + TASK_VEND];
+	m[RSTK_END]      = m[pc + TASK_REND];
+	if (!m[pc + TASK_STATUS]) {
+		m[pc + TASK_STATUS] = 1;
+		goto end;
+	}
+	goto run;
+
+/**
+When a check fails, a signal arrives or **THROW** is executed, *on_fault* 
+is jumped to with the exception code in **o->fault**. If the core has been 
+invalidated there is nothing more that can be done. Otherwise, if a **catch** 
+frame is active, the code is thrown to it, by unwinding the return stack to 
+the frame described in **CATCH** and restoring the variable stack. Any frames
+pushed by **EVALUATOR** since the **catch** are removed as well, restoring 
+the input source. 
+
+If there is no handler, or the handler is not valid, the **ERROR_HANDLER** 
+register decides what to do, the default is to reset the return stack and
+restart the interpreter loop. This does not throw away the input, so the
+interpreter carries on with the rest of it.
+**/
+on_fault:
+#ifdef USE_STACK_CACHE
+	if (cached) {
+		*++S = s;
+		cached = 0;
+	}
+#endif
+	TRACE_SYNC();
+	w = o->fault;
+	o->fault = 0;
+	if (forth_is_invalid(o))
+		goto invalid;
+	pc = m[THROW_HANDLER];
+	if (pc >= return_stack_start(o) + 4 && pc <= m[RSTK] 
+			&& m + m[pc - 2] >= o->vstart && m + m[pc - 2] < o->vend) {
+		while (m[EVAL_FRAME] > pc)
+			(void)evaluate_pop(o);
+		m[THROW_HANDLER] = m[pc];
+		S = m + m[pc - 2];
+		*++S = m[pc - 1];
+		f = w;
+		I = m[pc - 3];
+		m[RSTK] = pc - 4;
+		goto run;
+	}
+on_error:
+	switch (m[ERROR_HANDLER]) {
+	case ERROR_INVALIDATE: 
+		TRACE_SYNC();
+		forth_trace_dump(o, (FILE*)(o->m[STDERR]));
+		forth_invalidate(o);
+		/* fall-through */
+	case ERROR_HALT:       
+		rval = -forth_is_invalid(o);
+		goto end;
+	case ERROR_RECOVER:    
+		if (m[TASK] != m[MAIN_TASK]) { /* only the interpreter recovers */
+			w = m[TASK];
+			m[w + TASK_STATUS] = 0;
+			goto task_next;
+		}
+		m[RSTK] = m[EVAL_FRAME] != e ? 
+			m[EVAL_FRAME] + 1 : 
+			return_stack_start(o);
+		m[THROW_HANDLER] = 0;
+		break;
+	}
+warm:
+	I = m[INSTRUCTION];
+	S = o->S;
+	f = m[TOP];
+	goto run;
 }
 
 /**    
@@ -24,7 +24,7 @@ extern "C" {
 @brief This is the absolute minimum size the Forth virtual machine can be in
 Forth cells, not bytes. 
 **/
-#define MINIMUM_CORE_SIZE (2048)
+#define MINIMUM_CORE_SIZE (4096)
 
 /**
 @brief Default VM size which should be large enough for any Forth application,
@@ -43,7 +43,23 @@ is incompatible with previous or later versions, which is a deficiency of the
 program. A way to migrate core files would be useful, but the task is
 too difficult.
 **/
-#define FORTH_CORE_VERSION  (0x04u)
+#define FORTH_CORE_VERSION  (0x09u)
+
+/**
+@brief A core image compiled into a program, such as the one the Forth
+word "core2c" generates, is declared with **FORTH_CORE_IMAGE** so that it
+starts on a page boundary, which allows it to be mapped copy-on-write
+instead of copied, see **forth_load_core_image**.
+**/
+#ifndef FORTH_CORE_ALIGNMENT
+#define FORTH_CORE_ALIGNMENT (4096)
+#endif
+
+#ifdef __GNUC__
+#define FORTH_CORE_IMAGE __attribute__((aligned(FORTH_CORE_ALIGNMENT)))
+#else
+#define FORTH_CORE_IMAGE
+#endif
 
 struct forth; /**< An opaque object that holds a running FORTH environment**/
 typedef struct forth forth_t; /**< Typedef of opaque object for general use */
@@ -164,6 +180,20 @@ enum forth_debug_level
 	FORTH_DEBUG_ALL,         /**< trace everything that can be traced */
 };
 
+/**
+@brief The reason **forth_run** last returned, as reported by
+forth_status(). When it is waiting for input the state of the virtual
+machine is kept, so the next call to forth_run() carries on from where
+it stopped, in the middle of a word if need be.
+**/
+enum forth_status
+{
+	FORTH_STATUS_OK,          /**< input ran out, or 'bye' was called */
+	FORTH_STATUS_NEEDS_INPUT, /**< more input is needed, see forth_feed() */
+	FORTH_STATUS_BUDGET,      /**< the budget ran out, see forth_set_budget() */
+	FORTH_STATUS_INVALID,     /**< the core has been invalidated */
+};
+
 /**
 @brief Compute the binary logarithm of an integer value
 @param  x number to act on
@@ -267,7 +297,9 @@ forth_cell_t forth_stack_position(forth_t *o);
 @brief Alert a Forth environment to a signal, this function should be
 called from a signal handler to let the Forth environment know a signal
 has been caught. It will then set a register that can (but not necessarily 
-will be) checked when the Forth environment runs again.
+will be) checked when the Forth environment runs again. If the environment
+is running the signal is also thrown, as an exception, to the innermost
+**catch** the next time the virtual machine calls a word or branches.
 
 @param  o   initialized forth environment
 @param  sig caught signal value
@@ -291,7 +323,8 @@ void forth_free_words(char **s, size_t length);
 
 /**
 @brief This function returns a list of strings containing
-all of the names of words defined in a forth environment. This
+all of the names of words defined in a forth environment that are
+in the wordlists of the search order, latest first. This
 function returns NULL on failure and sets length to zero.
 @param o      initialized forth environment
 @param length length of returned array
@@ -323,6 +356,57 @@ values mean more verbose output.
 **/
 void forth_set_debug_level(forth_t *o, enum forth_debug_level level);
 
+/**
+@brief Limit how long each call to forth_run() can execute for. The
+budget is counted down by every word called and every branch taken, which
+is enough to stop any loop. When it runs out forth_run() returns with
+forth_status() set to FORTH_STATUS_BUDGET, and the next call carries on
+where it stopped with a new budget.
+@param o      initialized forth environment.
+@param budget calls and branches allowed per call, zero for no limit.
+**/
+void forth_set_budget(forth_t *o, forth_cell_t budget);
+
+/**
+@brief Start or stop the sampling profiler. The profiler keeps the last
+'samples' samples taken by forth_profile_sample() in a ring buffer, and
+turns sampling on, which can also be switched on and off from within
+the interpreter with the '`profiling' register.
+@param  o       initialized forth environment, asserted.
+@param  samples size of the ring buffer, zero to stop and free it.
+@return int     zero on success, negative on failure
+**/
+int forth_profile(forth_t *o, size_t samples);
+
+/**
+@brief Take a sample of the words being executed, this is meant to be
+called from a signal handler driven by a timer, such as SIGPROF with 
+setitimer(). It does nothing if profiling is off.
+@param o initialized forth environment, asserted.
+**/
+void forth_profile_sample(forth_t *o);
+
+/**
+@brief Write out the samples taken in the collapsed stack format used
+by flame graph tools, one line per call stack, with the words separated
+by semicolons and followed by the number of samples it was seen in.
+@param  o   initialized forth environment, asserted.
+@param  out file to write to, asserted.
+@return int zero on success, negative on failure
+**/
+int forth_profile_dump(forth_t *o, FILE *out);
+
+/**
+@brief Print out the most recently executed instructions, along with the
+instruction pointer and top of the stack for each, from a ring buffer that
+is always being written to. This is printed automatically when the
+interpreter is invalidated, it does not allocate memory so it can be 
+called from a signal handler as a last resort.
+@param o   initialized forth environment, asserted.
+@param out file to write to, asserted.
+**/
+void forth_trace_dump(forth_t *o, FILE *out);
+
 /** 
 @brief   Execute an initialized forth environment, this will read
 from input until there is no more or an error occurs. If
@@ -336,6 +420,13 @@ errors.
 **/
 int forth_run(forth_t *o); 
 
+/**
+@brief Find out why forth_run() last returned.
+@param  o An initialized forth environment. Asserted.
+@return enum forth_status
+**/
+enum forth_status forth_status(forth_t *o);
+
 /** 
 @brief   This function behaves like forth_run() but instead will
 read from a string until there is no more. It will like-
@@ -408,6 +499,17 @@ in binary mode ("rb").
 **/
 forth_t *forth_load_core_file(FILE *dump);
 
+/** 
+@brief  Load a Forth file from disk like forth_load_core_file, but
+also check the core against the CRC32C saved in its header by
+forth_save_core_file, so a corrupted file fails to load.
+
+@param  dump    a file handle opened on a Forth core dump, in binary
+mode ("rb").
+@return forth_t a reinitialized forth object, or NULL on failure
+**/
+forth_t *forth_load_verified_core_file(FILE *dump);
+
 /**
 @brief Load a core file from memory, much like forth_load_core_file. The
 size parameter must be greater or equal to the MINIMUM_CORE_SIZE, this
@@ -419,6 +521,20 @@ is asserted.
 **/
 forth_t *forth_load_core_memory(char *m, size_t size);
 
+/**
+@brief Make a Forth object that uses an image of a core in place as its
+memory, instead of copying it like forth_load_core_memory does. An image
+is a core without its header, it must be writable and must outlive the
+returned object, forth_free does not free it. This is meant for use with
+a private copy-on-write mapping of a core compiled into a program.
+
+@param m    core image, asserted
+@param size size of core image in cells, it must be a power of two
+that is greater or equal to MINIMUM_CORE_SIZE
+@return forth_t a reinitialized forth object, or NULL on failure
+**/
+forth_t *forth_load_core_image(forth_cell_t *m, size_t size);
+
 /**
 @brief Save a Forth object to memory, this function will allocate
 enough memory to store the core file. 
@@ -429,6 +545,80 @@ enough memory to store the core file.
 **/
 char *forth_save_core_memory(forth_t *o, size_t *size);
 
+/**
+@brief The virtual machine state shared between the interpreter and
+functions generated by forth_native_translate(). The functions take
+the state, run until the translated word exits or until they meet code
+that was not translated, and write the updated state back. Calls and
+branches in translated code use up **fuel** and are written to **ring**
+just as they are in the interpreter, and hand back to the interpreter
+before the last of the fuel is used or if **fault** is set, so that it
+can deal with them. Likewise they hand back to the interpreter before
+any instruction that would find too few items on the variable stack, or
+the stack already overflowed, so it can throw the error.
+**/
+struct forth_native_state {
+	forth_cell_t *m;    /**< virtual machine memory */
+	forth_cell_t *S;    /**< variable stack pointer */
+	forth_cell_t *vstart; /**< start of the variable stack */
+	forth_cell_t *vend; /**< end of the variable stack */
+	forth_cell_t f;     /**< top of the variable stack */
+	forth_cell_t I;     /**< instruction pointer to continue from */
+	forth_cell_t size;  /**< size of the core in cells */
+	volatile forth_cell_t *fault; /**< non zero if the interpreter must poll */
+	forth_cell_t fuel;  /**< calls and branches left before it must poll */
+	forth_cell_t (*ring)[2]; /**< trace ring buffer, or NULL if there is none */
+	size_t ring_mask;   /**< number of entries in **ring** less one */
+	size_t ring_next;   /**< count of entries written to **ring** */
+};
+
+/**
+@brief A word translated to C, it returns zero if the word exited and
+non zero if the interpreter has to continue execution from **I**.
+**/
+typedef int (*forth_native_t)(struct forth_native_state *st);
+
+/**
+@brief An entry in the table of translated words, **pc** is the address
+of the words body, that is the cell after its CODE field.
+**/
+struct forth_native {
+	forth_cell_t pc;          /**< start of translated word body */
+	forth_native_t function;  /**< translated body */
+};
+
+/**
+@brief Translate all of the words defined in a Forth core into C. The
+generated C file includes "libforth.h" and defines the following, which
+can be passed to forth_set_native():
+
+	const struct forth_native forth_native_table[];
+	const size_t forth_native_count;
+	const forth_cell_t forth_native_core_size;
+
+The translated code is only valid for the core it was generated from.
+
+@param  o   Forth core to translate, asserted
+@param  out file to write C code to, asserted
+@return int zero on success, negative on failure
+**/
+int forth_native_translate(forth_t *o, FILE *out);
+
+/**
+@brief Use a table of translated words, as generated by
+forth_native_translate(), when executing words in a Forth core. The
+table is not copied and should remain valid for the lifetime of
+the Forth object.
+
+@param  o         Forth core that the table was generated from
+@param  natives   table of translated words, sorted by **pc**
+@param  count     number of entries in the table
+@param  core_size size of the core the table was generated from
+@return int       zero on success, negative if the core is a different size
+**/
+int forth_set_native(forth_t *o, const struct forth_native *natives, 
+		size_t count, forth_cell_t core_size);
+
 /** 
 @brief   Define a new constant in an Forth environment.
 
@@ -475,6 +665,27 @@ void forth_set_block_input(forth_t *o, const char *s, size_t length);
 **/
 void forth_set_string_input(forth_t *o, const char *s); 
 
+/**
+@brief Add a block of memory to the input of an environment 'o'. The
+data is copied into a buffer held by the environment, so the block can
+be reused once this returns. Unlike the other input functions running
+out of fed input does not end the input, instead forth_run() returns
+with forth_status() set to FORTH_STATUS_NEEDS_INPUT, without consuming
+any partially read word, and carries on when it is next called. Calling
+forth_feed() with a NULL block marks the end of the input, the rest of
+the buffer is then read as normal. This should only be called when
+forth_run() is not running, and it fails if forth_run() returned part
+way through an 'evaluate', as it can when a budget is set, until the
+'evaluate' has finished.
+
+@param  o      An initialized FORTH environment. Caller frees. Asserted.
+@param  s      A block of memory to add to the input, or NULL.
+@param  length Length of block
+@return int    zero on success, negative if the buffer could not grow
+               or 'evaluate' has not finished
+**/
+int forth_feed(forth_t *o, const char *s, size_t length);
+
 /** 
 @brief Set the register elements in the Forth virtual machine for
 "argc" and "argv" to argc and argv, allowing them to be
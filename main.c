@@ -5,6 +5,10 @@
 @license    MIT
 @email      howe.r.j.89@gmail.com
 **/
+/* sigaction and setitimer, used by the profiler, are POSIX and XSI */
+#if defined(__unix__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600
+#endif
 #include "libforth.h"
 #include "unit.h"
 #include <assert.h>
@@ -23,8 +27,13 @@ extern int _fileno(FILE*);
 #endif
 
 #ifdef USE_BUILT_IN_CORE
-extern unsigned char forth_core_data[];
-extern forth_cell_t forth_core_size;
+extern const unsigned char forth_core_data[];
+extern const forth_cell_t forth_core_size;
+#ifdef USE_NATIVE_CORE
+extern const struct forth_native forth_native_table[];
+extern const size_t forth_native_count;
+extern const forth_cell_t forth_native_core_size;
+#endif
 #endif
 
 /**
@@ -34,6 +43,7 @@ global variable so signal handlers can access it.
 **/
 static forth_t *global_forth_environment; 
 static int enable_signal_handling;
+static const char *profile_name; /**< file to write profile to, if any */
 
 typedef void (*signal_handler)(int sig); /**< functions for handling signals*/
 
@@ -47,7 +57,8 @@ typedef void (*signal_handler)(int sig); /**< functions for handling signals*/
 This hander calls functions (backtrace, printf) that are not 
 safe to call from a signal handler, however this is only going to
 be called in the event of an internal consistency failure,
-and only as a courtesy to the programmer.
+and only as a courtesy to the programmer. As well as the C stack trace
+it prints the instructions the Forth virtual machine executed last.
 
 A windows version could be made using information from:
 https://msdn.microsoft.com/en-us/library/windows/desktop/bb204633%28v=vs.85%29.aspx and
@@ -66,6 +77,8 @@ static void sig_abrt_handler(int sig)
         fprintf(stderr, "SIGABRT was raised.\nStack trace:\n");
         for (i = 0; i < trace_size; i++)
                 fprintf(stderr, "\t%s\n", messages[i]);
+        if (global_forth_environment)
+                forth_trace_dump(global_forth_environment, stderr);
         fflush(stderr);
 fail:   
         abort();
@@ -151,7 +164,7 @@ end:
 static void register_signal_handler(int sig, signal_handler handler)
 {
 	errno = 0; 
-	if (signal(SIGINT, handler) == SIG_ERR) {
+	if (signal(sig, handler) == SIG_ERR) {
 		error("could not install %d handler: %s", sig, forth_strerror());
 		exit(EXIT_FAILURE);
 	}
@@ -167,6 +180,47 @@ static void sig_generic_handler(int sig)
 	}
 }
 
+/**
+The profiler is driven by a timer that counts the CPU time used by the
+process, which raises **SIGPROF** every **PROFILE_PERIOD** microseconds,
+the samples are written out to **profile_name** when the program exits.
+Only Unix systems have **setitimer**.
+**/
+#ifdef __unix__
+#include <sys/time.h>
+#define PROFILE_SAMPLES (1u << 16) /**< samples kept by the profiler */
+#define PROFILE_PERIOD  (1000u)    /**< sampling period in microseconds */
+
+static void sig_profile_handler(int sig)
+{
+	(void)sig;
+	if (global_forth_environment)
+		forth_profile_sample(global_forth_environment);
+}
+
+/**
+The handler is installed with **sigaction**, so that it stays installed
+and does not have to install itself again from within the handler, which
+could fail, and only async-signal-safe functions should be called there.
+**SA_RESTART** stops the timer from interrupting reads of the input.
+**/
+static int profile_start(void)
+{
+	struct itimerval t = { { 0, PROFILE_PERIOD }, { 0, PROFILE_PERIOD } };
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sig_profile_handler;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	if (sigaction(SIGPROF, &sa, NULL) < 0)
+		return -1;
+	return setitimer(ITIMER_PROF, &t, NULL);
+}
+#else
+#define PROFILE_SAMPLES (0u)
+static int profile_start(void) { return -1; }
+#endif
+
 /** 
 This program can be used as a filter in a Unix pipe chain, or as a standalone
 interpreter for Forth. It tries to follow the Unix philosophy and way of
@@ -194,7 +248,7 @@ static void usage(const char *name)
 {
 	fprintf(stderr, 
 		"usage: %s "
-		"[-(s|l|f) file] [-e expr] [-m size] [-LSVthvnx] [-] files\n", 
+		"[-(s|l|f|c|p) file] [-e expr] [-m size] [-LSVthvnxk] [-] files\n", 
 		name);
 }
 
@@ -219,6 +273,9 @@ static void help(void)
 "\t-f file   immediately read from and execute a file\n"
 "\t-l file   load previously saved state from file\n"
 "\t-L        load previously saved state from 'forth.core'\n"
+"\t-k        check the checksum of cores loaded with '-l' or '-L'\n"
+"\t-c file   translate the words in the interpreter to C, writing to file\n"
+"\t-p file   profile the interpreter, writing collapsed stacks to file\n"
 "\t-m size   specify forth memory size in KiB (cannot be used with '-l')\n"
 "\t-t        process stdin after processing forth files\n"
 "\t-v        turn verbose mode on\n"
@@ -263,6 +320,74 @@ static void version(void)
 		(unsigned)IS_BIG_ENDIAN);
 }
 
+#ifdef USE_BUILT_IN_CORE
+/**
+The core compiled into the program is an image of the memory of a virtual
+machine that has already read in "forth.fth", so starting up does not
+involve parsing anything. The image is read only and starts on a page
+boundary, on Linux the pages of the executable that hold it are mapped
+again as private and copy-on-write, so only the pages the interpreter
+writes to are ever copied. Elsewhere, or if mapping fails, it is copied.
+The image is needed for the lifetime of the program, so it is not freed.
+**/
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static off_t find_image(uintptr_t address)
+{
+	unsigned long start = 0, end = 0, offset = 0;
+	off_t r = -1;
+	FILE *maps = fopen("/proc/self/maps", "rb");
+	if (!maps)
+		return -1;
+	while (fscanf(maps, "%lx-%lx %*s %lx %*[^\n]", &start, &end, &offset) == 3) {
+		if (address >= start && address + forth_core_size <= end) {
+			r = offset + (address - start);
+			break;
+		}
+	}
+	fclose(maps);
+	return r;
+}
+
+static forth_cell_t *map_core_image(void)
+{
+	const long page = sysconf(_SC_PAGESIZE);
+	off_t offset = -1;
+	void *m = MAP_FAILED;
+	int fd;
+	if (page <= 0 || (uintptr_t)forth_core_data % page)
+		return NULL;
+	if ((offset = find_image((uintptr_t)forth_core_data)) < 0 || offset % page)
+		return NULL;
+	if ((fd = open("/proc/self/exe", O_RDONLY)) < 0)
+		return NULL;
+	m = mmap(NULL, forth_core_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset);
+	close(fd);
+	return m == MAP_FAILED ? NULL : m;
+}
+#else
+static forth_cell_t *map_core_image(void)
+{
+	return NULL;
+}
+#endif
+
+static forth_t *forth_load_built_in_core(void)
+{
+	forth_cell_t *m = map_core_image();
+	if (!m) {
+		errno = 0;
+		if (!(m = malloc(forth_core_size)))
+			return NULL;
+		memcpy(m, forth_core_data, forth_core_size);
+	}
+	return forth_load_core_image(m, forth_core_size / sizeof(forth_cell_t));
+}
+#endif
+
 static forth_t *forth_initial_enviroment(forth_t **o, forth_cell_t size, 
 		FILE *input, FILE *output, enum forth_debug_level verbose, 
 		int argc, char **argv)
@@ -273,14 +398,21 @@ static forth_t *forth_initial_enviroment(forth_t **o, forth_cell_t size,
 		goto finished;
 
 #ifdef USE_BUILT_IN_CORE
-	/* USE_BUILT_IN_CORE is an experimental feature, it should not be
-	 * relied upon to work correctly */
 	(void)size;
-	*o = forth_load_core_memory((char*)forth_core_data, forth_core_size);
+	*o = forth_load_built_in_core();
+	if (!(*o))
+		goto fail;
 	forth_set_file_input(*o, input);
 	forth_set_file_output(*o, output);
+#ifdef USE_NATIVE_CORE
+	if (forth_set_native(*o, forth_native_table, forth_native_count, forth_native_core_size) < 0)
+		warning("translated words do not match core, size %"PRIdCell, forth_native_core_size);
+#endif
 #else
 	*o = forth_init(size, input, output, NULL);
+#endif
+#ifdef USE_BUILT_IN_CORE
+fail:
 #endif
 	if (!(*o)) {
 		fatal("forth initialization failed, %s", forth_strerror());
@@ -290,6 +422,8 @@ static forth_t *forth_initial_enviroment(forth_t **o, forth_cell_t size,
 finished:
 	forth_set_debug_level(*o, verbose);
 	forth_set_args(*o, argc, argv);
+	if (profile_name && global_forth_environment != *o)
+		forth_profile(*o, PROFILE_SAMPLES);
 	global_forth_environment = *o;
 	return *o;
 }
@@ -312,6 +446,7 @@ int main(int argc, char **argv)
 	    eval = 0,            /* have we evaluated anything? */
 	    readterm = 0,        /* read from standard in */
 	    use_line_editor = 0, /* use a line editor, *if* one exists */
+	    verify = 0,          /* check core files against their checksum */
 	    mset = 0;            /* memory size specified */
 	enum forth_debug_level verbose = FORTH_DEBUG_OFF; /* verbosity level */
 	static const size_t kbpc = 1024 / sizeof(forth_cell_t); /*kilobytes per cell*/
@@ -415,13 +550,30 @@ sacrifice portability.
 		case 'L':
 			if (verbose >= FORTH_DEBUG_NOTE)
 				note("loading core file '%s'", dump_name);
-			if (!(o = forth_load_core_file(dump = forth_fopen_or_die(dump_name, "rb")))) {
+			dump = forth_fopen_or_die(dump_name, "rb");
+			if (!(o = verify ? forth_load_verified_core_file(dump) : forth_load_core_file(dump))) {
 				fatal("%s, core load failed", dump_name);
 				return -1;
 			}
 			forth_set_debug_level(o, verbose);
 			fclose(dump);
 			break;
+		case 'c':
+			if (i >= (argc - 1))
+				goto fail;
+			forth_initial_enviroment(&o, core_size, stdin, stdout, verbose, orig_argc, orig_argv);
+			optarg = argv[++i];
+			if (verbose >= FORTH_DEBUG_NOTE)
+				note("translating words to C, writing to '%s'", optarg);
+			dump = forth_fopen_or_die(optarg, "wb");
+			rval = forth_native_translate(o, dump);
+			fclose(dump);
+			if (rval < 0) {
+				fatal("translation to '%s' failed", optarg);
+				goto end;
+			}
+			eval = 1;
+			break;
 		case 'v':
 			verbose++;
 			break;
@@ -432,6 +584,18 @@ sacrifice portability.
 		case 'x':
 			enable_signal_handling = 1;
 			break;
+		case 'k':
+			verify = 1;
+			break;
+		case 'p':
+			if (o || (i >= argc - 1))
+				goto fail;
+			profile_name = argv[++i];
+			if (profile_start() < 0) {
+				fatal("could not start profiler, %s", forth_strerror());
+				return -1;
+			}
+			break;
 		default:
 		fail:
 			fatal("invalid argument '%s'", argv[i]);
@@ -488,6 +652,16 @@ state with invalid data.
 		fclose(dump);
 	}
 
+	if (profile_name) {
+		if (verbose >= FORTH_DEBUG_NOTE)
+			note("writing profile to '%s'", profile_name);
+		if (forth_profile_dump(o, dump = forth_fopen_or_die(profile_name, "wb")) < 0) {
+			fatal("profile write to '%s' failed", profile_name);
+			rval = -1;
+		}
+		fclose(dump);
+	}
+
 /** 
 Whilst the following **forth_free** is not strictly necessary, there
 is often a debate that comes up making short lived programs or programs whose
@@ -11,6 +11,7 @@
 /**********************/
 
 #include <assert.h>
+#include <locale.h>
 #include <setjmp.h>
 #include <signal.h>
 #include <stdint.h>
@@ -215,6 +216,43 @@ static int forth_function_2(forth_t *f)
 	return 0;
 }
 
+/* forth_function_sample takes a profiler sample, as a timer would */
+static int forth_function_sample(forth_t *f)
+{
+	forth_profile_sample(f);
+	return 0;
+}
+
+/* native_square and native_spin are written by hand in the same way
+forth_native_translate writes translated words, for ": square dup * ;" and
+": spin begin again ;", the addresses they need are found when testing */
+static forth_cell_t native_square_pc, native_multiply, native_spin_pc;
+static unsigned native_square_runs, native_spin_loops;
+
+static int native_square(struct forth_native_state *st)
+{
+	forth_cell_t p = native_square_pc;
+	native_square_runs++;
+	if (st->m[p + 1] != native_multiply) { /* the word has been changed */
+		st->I = p;
+		return 1;
+	}
+	st->f *= st->f;
+	st->I = p + 2; /* the interpreter can deal with the exit */
+	return 1;
+}
+
+static int native_spin(struct forth_native_state *st)
+{
+	for (;; native_spin_loops++) {
+		if (*st->fault || st->fuel <= 1) {
+			st->I = native_spin_pc;
+			return 1;
+		}
+		st->fuel--;
+	}
+}
+
 int libforth_unit_tests(int keep_files, int colorize, int silent)
 {
 	tb.is_silent = silent;
@@ -238,6 +276,20 @@ int libforth_unit_tests(int keep_files, int colorize, int silent)
 		test(&tb, 16 == forth_round_up_pow2(9));
 		test(&tb, 64 == forth_round_up_pow2(37));
 	}
+	{
+		forth_cell_t n = 0;
+		test(&tb, !forth_string_to_cell(10, &n, "123") && n == 123);
+		test(&tb, !forth_string_to_cell(16, &n, "-fF") && n == (forth_cell_t)-255);
+		test(&tb, !forth_string_to_cell(0,  &n, "0x10") && n == 16);
+		test(&tb, !forth_string_to_cell(0,  &n, "017") && n == 15);
+		test(&tb, !forth_string_to_cell(10, &n, "%101") && n == 5);
+		test(&tb, !forth_string_to_cell(2,  &n, "$7f") && n == 127);
+		test(&tb, forth_string_to_cell(10, &n, ""));
+		test(&tb, forth_string_to_cell(10, &n, "-"));
+		test(&tb, forth_string_to_cell(10, &n, "12a"));
+		test(&tb, forth_string_to_cell(8,  &n, "8"));
+		test(&tb, forth_string_to_cell(10, &n, "99999999999999999999999"));
+	}
 	{
 		/**@note The following functions will not be tested:
 		 * 	- void forth_set_file_output(forth_t *o, FILE *out);
@@ -280,6 +332,9 @@ int libforth_unit_tests(int keep_files, int colorize, int silent)
 		test(&tb, forth_pop(f) == 9);
 		state(&tb, forth_set_file_input(f, stdin));
 
+		/* the floating point stack is saved with the core */
+		test(&tb, forth_eval(f, "1.5e0 2.5e0 f+ ") >= 0);
+
 		/* save core for later tests */
 		test(&tb, forth_save_core_file(f, core) >= 0);
 		state(&tb, fclose(core));
@@ -331,10 +386,34 @@ int libforth_unit_tests(int keep_files, int colorize, int silent)
 		test(&tb, forth_eval(f, "unit-01 constant-1 *") >= 0);
 		test(&tb, forth_pop(f) == 69 * 0xAA0A);
 		test(&tb, 0 == forth_stack_position(f));
+		test(&tb, forth_eval(f, "fdepth f>s ") >= 0);
+		test(&tb, forth_pop(f) == 4);
+		test(&tb, forth_pop(f) == 1);
 
 		state(&tb, forth_free(f));
 		state(&tb, fclose(core));
 	}
+	{ /* test a corrupted core fails to load if it is verified */
+		FILE *core;
+		forth_t *f;
+		int c;
+		state(&tb, core = fopen("unit.core", "rb+"));
+		must(&tb, core);
+		state(&tb, f = forth_load_verified_core_file(core));
+		must(&tb, f);
+		state(&tb, forth_free(f));
+
+		state(&tb, fseek(core, 100, SEEK_SET));
+		state(&tb, c = fgetc(core));
+		state(&tb, fseek(core, 100, SEEK_SET));
+		state(&tb, fputc(c ^ 0x10, core));
+		state(&tb, rewind(core));
+		test(&tb, !forth_load_verified_core_file(core));
+
+		state(&tb, fseek(core, 100, SEEK_SET));
+		state(&tb, fputc(c, core));
+		state(&tb, fclose(core));
+	}
 	{ /* test invalidation fails */
 		FILE *core;
 		forth_t *f;
@@ -437,6 +516,93 @@ int libforth_unit_tests(int keep_files, int colorize, int silent)
 		test(&tb, forth_eval(f, "0 call") >= 0);
 		test(&tb, forth_pop(f)); 
 
+		/* by default errors are recovered from and the rest of the
+		 * input is still read in */
+		test(&tb, forth_eval(f, " 1 0 / 2 3 + ") >= 0);
+		test(&tb, forth_pop(f) == 5);
+		test(&tb, 0 == forth_stack_position(f));
+
+		/* errors are thrown to catch, with the stack restored */
+		test(&tb, forth_eval(f, " 1 0 find / catch ") >= 0);
+		test(&tb, forth_pop(f) == (forth_cell_t)-10);
+		test(&tb, forth_pop(f) == 0);
+		test(&tb, forth_pop(f) == 1);
+		test(&tb, forth_eval(f, " 3 find throw catch 4 0 throw ") >= 0);
+		test(&tb, forth_pop(f) == 4);
+		test(&tb, forth_pop(f) == 3);
+		test(&tb, forth_pop(f) == 3);
+		test(&tb, 0 == forth_stack_position(f));
+
+		/* unless `error-handler says we should halt */
+		test(&tb, forth_eval(f, " 1 `error-handler ! 7 1 0 / 8 ") >= 0);
+		test(&tb, forth_pop(f) == 0);
+		test(&tb, forth_pop(f) == 7);
+		test(&tb, !forth_is_invalid(f));
+		test(&tb, forth_eval(f, " 2 `error-handler ! 1 0 / ") < 0);
+		test(&tb, forth_is_invalid(f));
+
+		state(&tb, forth_free(f));
+	}
+	{ /* input fed in a block at a time */
+		forth_t *f = NULL;
+		FILE *in = NULL;
+		int refused = 0;
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, NULL));
+		must(&tb, f);
+
+		/* words split between blocks are not lost */
+		test(&tb, forth_feed(f, " : sq dup * ; 1", 15) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_NEEDS_INPUT);
+		test(&tb, 0 == forth_stack_position(f));
+		test(&tb, forth_feed(f, "2 sq 3", 6) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_NEEDS_INPUT);
+		test(&tb, forth_pop(f) == 144);
+
+		/* as are words in the middle of reading input */
+		test(&tb, forth_feed(f, " 4 :", 4) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_feed(f, " cube dup sq * ; 2 cu", 21) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_feed(f, "be", 2) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, 3 == forth_stack_position(f));
+
+		/* until the end of the input is fed in */
+		test(&tb, forth_feed(f, NULL, 0) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_OK);
+		test(&tb, forth_pop(f) == 8);
+		test(&tb, forth_pop(f) == 4);
+		test(&tb, forth_pop(f) == 3);
+
+		/* a budget makes forth_run return early, but it carries on */
+		state(&tb, forth_set_budget(f, 4));
+		test(&tb, forth_eval(f, " 0 1 + 1 + 1 + 1 + 1 + ") >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_BUDGET);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_BUDGET);
+		state(&tb, while (forth_status(f) == FORTH_STATUS_BUDGET) forth_run(f));
+		test(&tb, forth_status(f) == FORTH_STATUS_OK);
+		test(&tb, forth_pop(f) == 5);
+
+		/* but input cannot be fed in until an evaluate finishes */
+		state(&tb, in = tmpfile());
+		must(&tb, in);
+		state(&tb, fputs("0 1 + 1 + 1 + 1 +", in));
+		state(&tb, rewind(in));
+		test(&tb, forth_define_constant(f, "in-file", (forth_cell_t)in) >= 0);
+		test(&tb, forth_feed(f, "in-file 0 1 evaluator drop", 26) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		state(&tb, for (; forth_status(f) == FORTH_STATUS_BUDGET; forth_run(f)) refused += forth_feed(f, "", 0) < 0);
+		test(&tb, refused > 0);
+		test(&tb, forth_feed(f, " 2 +", 4) >= 0);
+		test(&tb, forth_feed(f, NULL, 0) >= 0);
+		test(&tb, forth_run(f) >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_OK);
+		test(&tb, forth_pop(f) == 6);
+		state(&tb, fclose(in));
 		state(&tb, forth_free(f));
 	}
 	{ /* tests for CALL */
@@ -469,6 +635,171 @@ int libforth_unit_tests(int keep_files, int colorize, int silent)
 		state(&tb, forth_free(f));
 		state(&tb, forth_delete_function_list(ff));
 	}
+	{ /* the sampling profiler */
+		forth_t *f = NULL;
+		struct forth_functions *ff;
+		FILE *out = NULL;
+		char line[64] = { 0 };
+		state(&tb, ff = forth_new_function_list(1));
+		must(&tb, ff);
+		state(&tb, ff->functions[0].function = forth_function_sample);
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, ff));
+		must(&tb, f);
+		test(&tb, forth_profile(f, 4) >= 0);
+		test(&tb, forth_eval(f, ": leaf 0 call drop ; : root leaf ; root root") >= 0);
+		state(&tb, out = tmpfile());
+		must(&tb, out);
+		test(&tb, forth_profile_dump(f, out) >= 0);
+		state(&tb, rewind(out));
+		test(&tb, fgets(line, sizeof(line), out) != NULL);
+		test(&tb, !strcmp(line, "root;leaf 2\n"));
+		state(&tb, fclose(out));
+		test(&tb, forth_profile(f, 0) >= 0);
+		state(&tb, forth_free(f));
+		state(&tb, forth_delete_function_list(ff));
+	}
+	{ /* bulk loading of numbers from a file */
+		forth_t *f = NULL;
+		FILE *in = NULL;
+		forth_cell_t i;
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE * 4, stdin, stdout, NULL));
+		must(&tb, f);
+		state(&tb, in = tmpfile());
+		must(&tb, in);
+		for (i = 0; i < 2000; i++) /* spans several reads */
+			fprintf(in, "%d,%s", (int)i, i % 10 == 9 ? "\n" : " ");
+		state(&tb, fputs("x, 3", in));
+		state(&tb, rewind(in));
+		test(&tb, forth_define_constant(f, "in-file", (forth_cell_t)in) >= 0);
+		test(&tb, forth_eval(f, "here 2000 44 in-file read-cells") >= 0);
+		test(&tb, forth_pop(f) == 0);
+		test(&tb, forth_pop(f) == 2000);
+		test(&tb, forth_eval(f, "here 1234 + @ here 1999 + @") >= 0);
+		test(&tb, forth_pop(f) == 1999);
+		test(&tb, forth_pop(f) == 1234);
+		test(&tb, fgetc(in) == 'x'); /* stopped at the field in error */
+		state(&tb, fclose(in));
+		state(&tb, forth_free(f));
+	}
+	{ /* evaluating a file, then carrying on with the outer input */
+		forth_t *f = NULL;
+		FILE *in = NULL;
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, NULL));
+		must(&tb, f);
+		state(&tb, in = tmpfile());
+		must(&tb, in);
+		state(&tb, fputs("2 3 +", in));
+		state(&tb, rewind(in));
+		test(&tb, forth_define_constant(f, "in-file", (forth_cell_t)in) >= 0);
+		test(&tb, forth_eval(f, "in-file 0 1 evaluator 7") >= 0);
+		test(&tb, forth_pop(f) == 7);
+		test(&tb, forth_pop(f) == 0);
+		test(&tb, forth_pop(f) == 5);
+		test(&tb, forth_eval(f, "8") >= 0);
+		test(&tb, forth_pop(f) == 8);
+		test(&tb, forth_stack_position(f) == 0);
+		state(&tb, fclose(in));
+		state(&tb, forth_free(f));
+	}
+	{ /* floating point numbers are printed in fixed point notation */
+		forth_t *f = NULL;
+		FILE *out = NULL;
+		char line[128] = { 0 };
+		state(&tb, out = tmpfile());
+		must(&tb, out);
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, out, NULL));
+		must(&tb, f);
+		test(&tb, forth_eval(f, "1e20 f. 1.5e f. -0.25e0 f. 3e0 f.") >= 0);
+		state(&tb, fflush(out));
+		state(&tb, rewind(out));
+		test(&tb, fgets(line, sizeof(line), out) != NULL);
+		test(&tb, !strcmp(line, "100000000000000000000. 1.5 -0.25 3. "));
+		/* numbers are read and printed the same way in any locale */
+		if (setlocale(LC_NUMERIC, "de_DE.UTF-8")) {
+			state(&tb, rewind(out));
+			test(&tb, forth_eval(f, "2.5e0 f. 2.5e0 fs.") >= 0);
+			state(&tb, fflush(out));
+			state(&tb, rewind(out));
+			test(&tb, fgets(line, sizeof(line), out) != NULL);
+			test(&tb, !strncmp(line, "2.5 2.50000000000000e+00 ", 25));
+			state(&tb, setlocale(LC_NUMERIC, "C"));
+		}
+		/* without an exponent a number with a point is a double cell one */
+		test(&tb, forth_eval(f, "1. -3. d+") >= 0);
+		test(&tb, (forth_cell_t)-1 == forth_pop(f));
+		test(&tb, (forth_cell_t)-2 == forth_pop(f));
+		state(&tb, forth_free(f));
+		state(&tb, fclose(out));
+	}
+	{ /* the trace ring buffer */
+		forth_t *f = NULL;
+		FILE *out = NULL;
+		char line[128] = { 0 };
+		int called = 0;
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, NULL));
+		must(&tb, f);
+		test(&tb, forth_eval(f, ": square dup * ; : cube dup square * ; 3 cube") >= 0);
+		state(&tb, out = tmpfile());
+		must(&tb, out);
+		state(&tb, forth_trace_dump(f, out));
+		state(&tb, rewind(out));
+		while (fgets(line, sizeof(line), out))
+			if (strstr(line, "cube") && strstr(line, "square"))
+				called = 1;
+		test(&tb, called);
+		state(&tb, fclose(out));
+		state(&tb, forth_free(f));
+	}
+	{ /* translation of words to C */
+		forth_t *f = NULL;
+		FILE *out = NULL;
+		long length = 0;
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, NULL));
+		must(&tb, f);
+		test(&tb, forth_eval(f, ": square dup * ; : cube dup square * ;") >= 0);
+		state(&tb, out = tmpfile());
+		must(&tb, out);
+		test(&tb, forth_native_translate(f, out) >= 0);
+		state(&tb, length = ftell(out));
+		test(&tb, length > 0);
+		/* tables generated for a different core size are rejected */
+		test(&tb, forth_set_native(f, NULL, 0, MINIMUM_CORE_SIZE * 2) < 0);
+		test(&tb, forth_set_native(f, NULL, 0, MINIMUM_CORE_SIZE) >= 0);
+		test(&tb, forth_eval(f, "3 cube") >= 0);
+		test(&tb, 27 == forth_pop(f));
+		state(&tb, fclose(out));
+		state(&tb, forth_free(f));
+	}
+	{ /* running translated words */
+		forth_t *f = NULL;
+		struct forth_native table[2];
+		state(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, NULL));
+		must(&tb, f);
+		test(&tb, forth_eval(f, ": square dup * ; : spin begin again ;") >= 0);
+		test(&tb, forth_eval(f, "find square find spin find *") >= 0);
+		state(&tb, native_multiply  = forth_pop(f));
+		state(&tb, native_spin_pc   = forth_pop(f) + 1);
+		state(&tb, native_square_pc = forth_pop(f) + 1);
+		state(&tb, table[0].pc = native_square_pc);
+		state(&tb, table[0].function = native_square);
+		state(&tb, table[1].pc = native_spin_pc);
+		state(&tb, table[1].function = native_spin);
+		test(&tb, forth_set_native(f, table, 2, MINIMUM_CORE_SIZE) >= 0);
+		test(&tb, forth_eval(f, "7 square") >= 0);
+		test(&tb, 49 == forth_pop(f));
+		test(&tb, 1 == native_square_runs);
+		/* a changed word is handed back to the interpreter */
+		test(&tb, forth_eval(f, "find + find square 2 + !") >= 0);
+		test(&tb, forth_eval(f, "7 square") >= 0);
+		test(&tb, 14 == forth_pop(f));
+		test(&tb, 2 == native_square_runs);
+		/* and translated loops use up the budget */
+		state(&tb, forth_set_budget(f, 100));
+		test(&tb, forth_eval(f, "spin") >= 0);
+		test(&tb, forth_status(f) == FORTH_STATUS_BUDGET);
+		test(&tb, native_spin_loops > 90 && native_spin_loops < 100);
+		state(&tb, forth_free(f));
+	}
 	{ 
 		FILE *core = NULL;
 		forth_t *f1 = NULL, *f2 = NULL;
@@ -495,6 +826,29 @@ int libforth_unit_tests(int keep_files, int colorize, int silent)
 		if (!keep_files)
 			state(&tb, remove("unit.core"));
 	}
+	{
+		forth_t *f = NULL;
+		forth_cell_t *image = NULL, size = 0;
+		const size_t bytes = MINIMUM_CORE_SIZE * sizeof(forth_cell_t);
+		char *m = NULL;
+		must(&tb, f = forth_init(MINIMUM_CORE_SIZE, stdin, stdout, NULL));
+		test(&tb, forth_eval(f, ": square dup * ;") >= 0);
+		must(&tb, m = forth_save_core_memory(f, &size));
+		state(&tb, forth_free(f));
+		/* an image is the core without the header in front of it */
+		must(&tb, image = malloc(bytes));
+		state(&tb, memcpy(image, m + (size - bytes), bytes));
+		test(&tb, !forth_load_core_image(image, MINIMUM_CORE_SIZE - 1));
+		must(&tb, f = forth_load_core_image(image, MINIMUM_CORE_SIZE));
+		test(&tb, forth_eval(f, "7 square") >= 0);
+		test(&tb, 49 == forth_pop(f));
+		/* the image is used in place, not copied */
+		test(&tb, forth_eval(f, ": cube dup square * ;") >= 0);
+		test(&tb, memcmp(image, m + (size - bytes), bytes));
+		state(&tb, forth_free(f));
+		state(&tb, free(image));
+		state(&tb, free(m));
+	}
 	return !!unit_test_end(&tb, "libforth");
 }
 